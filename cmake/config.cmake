@@ -4,6 +4,13 @@ set_property(CACHE ARCH PROPERTY STRINGS "x86_64")
 set(MACHINE "QEMU" CACHE STRING "The machine type that Eterna will run on")
 set_property(CACHE MACHINE PROPERTY STRINGS "PC" "QEMU" "VBOX" "VMWARE")
 
+set(UART_BAUD_RATE "115200" CACHE STRING "Baud rate of the COM1 serial port. Must divide 115200 evenly (115200, 57600, 38400, 19200, 9600, ...).")
+
+set(LOG_LEVEL "Info" CACHE STRING "Lowest level of `LOG` messages compiled into the kernel. Levels compiled in can still be masked per subsystem at runtime. Trace or Debug enable verbose PMM, VMM, heap and UART output.")
+set_property(CACHE LOG_LEVEL PROPERTY STRINGS "Trace" "Debug" "Info" "Warning" "Error" "None")
+
 option(HIDE_UART_COLOR_CODES "Do not print ANSI terminal color codes to serial output. Particularly useful if the terminal you are using does not support it. ON by default for compatibility reasons." ON)
 
-option(QEMU_DEBUG "Start QEMU with `-S -s` flags, halting startup until a debugger has been attached." OFF)
\ No newline at end of file
+option(QEMU_DEBUG "Start QEMU with `-S -s` flags, halting startup until a debugger has been attached." OFF)
+
+option(HEAP_PROFILER "Record per-callsite heap allocation statistics, printed by the `heapprof` command. Adds a pointer to every heap segment header. OFF by default." OFF)
@@ -9,6 +9,13 @@
 #define KERNEL_PHYSICAL 0x100000
 #define KERNEL_VIRTUAL 0xffffffff80000000
 
+static inline uint64_t rdtsc() {
+    uint32_t low;
+    uint32_t high;
+    __asm__ volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
 EFI_HANDLE gImageHandle;
 EFI_SYSTEM_TABLE* gSystemTable;
 EFI_BOOT_SERVICES* gBootServices;
@@ -167,9 +174,13 @@ typedef struct {
     UINTN mapSize;
     UINTN mapDescSize;
     void* RSDP;
+    // Time-stamp counter values, for the kernel's boot chart.
+    uint64_t loaderStart;
+    uint64_t loaderExit;
 } BootInfo;
 
 EFI_STATUS efi_main(EFI_HANDLE IH, EFI_SYSTEM_TABLE* ST) {
+    uint64_t loaderStart = rdtsc();
     gImageHandle = IH;
     gSystemTable = ST;
     gBootServices = gSystemTable->BootServices;
@@ -332,6 +343,7 @@ EFI_STATUS efi_main(EFI_HANDLE IH, EFI_SYSTEM_TABLE* ST) {
     info.mapSize = MapSize;
     info.mapDescSize = DescriptorSize;
     info.RSDP = rsdp;
+    info.loaderStart = loaderStart;
 
     Print(L"Kernel entry point: 0x%x\n", elf_header.e_entry);
     Print(L"Calculated kernel entry point: 0x%x\n",
@@ -346,6 +358,7 @@ EFI_STATUS efi_main(EFI_HANDLE IH, EFI_SYSTEM_TABLE* ST) {
     void (*KernelStart)(BootInfo*) =
         ((__attribute__((sysv_abi)) void (*)(BootInfo*))elf_header.e_entry -
          KERNEL_VIRTUAL);
+    info.loaderExit = rdtsc();
     KernelStart(&info);
 
     // Once boot services have been exited, must never return!
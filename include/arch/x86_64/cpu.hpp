@@ -0,0 +1,148 @@
+#ifndef _CPU_HPP
+#define _CPU_HPP
+
+#include <cstdint>
+
+// Upper bound on the number of processors per-CPU data is sized for.
+#ifndef CPU_MAX_COUNT
+#define CPU_MAX_COUNT 8
+#endif
+
+// Size of a cache line; data written by different processors is padded apart by this.
+#define CACHE_LINE_SIZE 64
+
+namespace CPU {
+/**
+ * @return the index of the processor executing the caller, in the
+ *      range [0, CPU_MAX_COUNT).
+ *
+ * @note Only the bootstrap processor is brought up so far.
+ */
+inline uint64_t current_index() {
+    return 0;
+}
+
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& eax, uint32_t& ebx,
+                  uint32_t& ecx, uint32_t& edx) {
+    asm volatile("cpuid"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(leaf), "c"(subleaf));
+}
+
+// Read extended control register `index` (requires CR4.OSXSAVE).
+inline uint64_t xgetbv(uint32_t index) {
+    uint32_t low;
+    uint32_t high;
+    asm volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(index));
+    return ((uint64_t)high << 32) | low;
+}
+
+// @return whether maskable interrupts are enabled (RFLAGS.IF).
+inline bool interrupts_enabled() {
+    uint64_t flags;
+    asm volatile("pushfq\n"
+                 "pop %0"
+                 : "=r"(flags));
+    return flags & (1 << 9);
+}
+
+/**
+ * @brief What the boot processor supports, as reported by CPUID.
+ *      Filled once by `detect_features()`.
+ */
+struct Features {
+    char Vendor[13];
+    char Brand[49];
+    uint32_t MaxLeaf;
+    uint32_t MaxExtendedLeaf;
+    uint32_t Family;
+    uint32_t Model;
+    uint32_t Stepping;
+
+    // CPUID.01H:EDX
+    bool FPU;
+    bool TSC;
+    bool MSR;
+    bool APIC;
+    bool PGE;
+    bool PAT;
+    bool FXSR;
+    bool SSE;
+    bool SSE2;
+    // CPUID.01H:ECX
+    bool SSE3;
+    bool SSSE3;
+    bool SSE4_1;
+    bool SSE4_2;
+    bool PCID;
+    bool x2APIC;
+    bool POPCNT;
+    bool TSCDeadline;
+    bool XSAVE;
+    bool OSXSAVE;
+    bool AVX;
+    bool RDRAND;
+    // CPUID.(EAX=07H,ECX=0):EBX
+    bool FSGSBASE;
+    bool BMI1;
+    bool AVX2;
+    bool SMEP;
+    bool BMI2;
+    bool ERMS;
+    bool INVPCID;
+    bool AVX512F;
+    bool SMAP;
+    // CPUID.(EAX=07H,ECX=0):EDX
+    bool FSRM;
+    // CPUID.(EAX=0DH,ECX=1):EAX
+    bool XSAVEOPT;
+    // CPUID.80000001H:ECX
+    bool LZCNT;
+    // CPUID.80000001H:EDX
+    bool NX;
+    bool Page1GB;
+    bool RDTSCP;
+    // CPUID.80000007H:EDX
+    bool InvariantTSC;
+
+    // AVX is supported *and* the OS has enabled saving its state (XCR0).
+    bool AVXUsable;
+};
+
+/**
+ * @brief Run CPUID and cache the results. Call again after changing
+ *      CR4/XCR0 so that `AVXUsable` reflects the new state.
+ */
+void detect_features();
+
+// @return the features cached by the last `detect_features()`.
+const Features& features();
+
+void print_features();
+
+/**
+ * @brief Measure how fast the time-stamp counter ticks (against the PIT)
+ *      and remember it for `tsc_frequency()`.
+ */
+void calibrate_tsc();
+
+// @return the time-stamp counter's frequency in Hz, or 0 until calibrated.
+uint64_t tsc_frequency();
+
+// @return how many microseconds `ticks` of the time-stamp counter take, or 0 if uncalibrated.
+uint64_t tsc_to_microseconds(uint64_t ticks);
+
+/**
+ * @return the value of the processor's time-stamp counter.
+ *
+ * @note Not serializing; only meaningful for coarse measurements.
+ */
+inline uint64_t rdtsc() {
+    uint32_t low;
+    uint32_t high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+}  // namespace CPU
+
+#endif  // !_CPU_HPP
@@ -0,0 +1,60 @@
+#ifndef _FPU_HPP
+#define _FPU_HPP
+
+#include <cstdint>
+
+// Size of each save area; enough for x87, SSE and AVX state in XSAVE format.
+#define FPU_SAVE_AREA_SIZE 1024
+
+// How deeply `kernel_fpu_begin()` sections may nest (interrupts included).
+#define FPU_MAX_NESTING 4
+
+namespace FPU {
+/**
+ * @brief Enable x87/SSE (CR0, CR4.OSFXSR/OSXMMEXCPT) and, when supported,
+ *      XSAVE and AVX state (CR4.OSXSAVE, XCR0), then reset the FPU.
+ *      Re-runs `CPU::detect_features()` so `AVXUsable` is up to date.
+ */
+void initialize();
+
+// @return the number of bytes the save instruction in use writes.
+uint64_t save_area_size();
+
+enum class SaveMode {
+    None,
+    FXSAVE,
+    XSAVE,
+    XSAVEOPT,
+};
+
+// How sections save vector state; chosen by `initialize()`.
+extern SaveMode gSaveMode;
+// State components enabled in XCR0, and so saved by XSAVE.
+extern uint64_t gStateMask;
+}  // namespace FPU
+
+/**
+ * @brief Open a section that may use vector registers.
+ *
+ *  Interrupt handlers themselves are built with `-mgeneral-regs-only`,
+ *  but the rest of the kernel is not, and the compiler uses vector
+ *  registers wherever it likes (to zero a struct, say). So a handler
+ *  must call kernel code only from inside a section, as
+ *  `uart_com1_handler` does. A section opened from a handler (whose gate
+ *  cleared IF) or nested inside another one always saves the current
+ *  state with XSAVEOPT (XSAVE, FXSAVE) for `kernel_fpu_end()` to restore.
+ *  Handlers that never return, like the fatal exception handlers, may
+ *  skip this.
+ *
+ *  A section opened from ordinary code with interrupts enabled saves
+ *  nothing: no vector register is live across a call in the System V
+ *  ABI, and any handler that interrupts it saves its own.
+ *
+ *  Sections must be closed in the reverse order they were opened.
+ */
+void kernel_fpu_begin();
+
+// Close the innermost section, restoring state it saved, if any.
+void kernel_fpu_end();
+
+#endif  // !_FPU_HPP
@@ -20,9 +20,21 @@ public:
 
     bool operator[](uint64_t index);
 
+    /**
+     * @return the index of the first bit at or after `from` that is
+     *      `value`, or the number of bits in the map if there is none.
+     */
+    uint64_t find(bool value, uint64_t from);
+
 private:
     uint64_t Size;
     uint8_t* Buffer;
 };
 
+/**
+ * @brief Bind `Bitmap::find()` to the fastest scan the CPU supports.
+ *      Call once after `CPU::detect_features()`.
+ */
+void bitmap_select_routines();
+
 #endif  // !_BITMAP_HPP
\ No newline at end of file
@@ -29,36 +29,73 @@ bool strcmp(const char* a, const char* b, uint64_t length);
 
 const char* to_string(bool);
 
-constexpr uint64_t TO_STRING_BUF_SZ = 20;
-constexpr uint64_t TO_STRING_BUF_SZ_DBL = 40;
-
-char* to_string(uint64_t);
-char* to_string(uint32_t);
-char* to_string(uint16_t);
-char* to_string(uint8_t);
-
-char* to_string(int64_t);
-char* to_string(int32_t);
-char* to_string(int16_t);
-char* to_string(int8_t);
-
-char* to_string(double, uint8_t decimalPlaces = 2);
-char* to_hexstring(uint64_t value, bool capital = false);
-
-extern const char to_hex_not_supported[];
-
-template <typename T>
-char* to_hexstring(T value, bool capital = false) {
-    switch (sizeof(T)) {
-        case 1:
-        case 2:
-        case 4:
-        case 8:
-            return to_hexstring((uint64_t)value, capital);
-
-        default:
-            return (char*)to_hex_not_supported;
-    }
+// Room for any 64-bit integer in decimal: 20 digits, a sign and the NUL.
+constexpr uint64_t TO_STRING_BUF_SZ = 22;
+// Most digits `to_string(double, ...)` will print after the point.
+constexpr uint8_t TO_STRING_MAX_DECIMALS = 18;
+// Room for any double, in fixed or exponent form.
+constexpr uint64_t TO_STRING_BUF_SZ_DBL = 48;
+// Room for 16 hexadecimal digits and the NUL.
+constexpr uint64_t TO_HEXSTRING_BUF_SZ = 17;
+
+// @return how many decimal digits `value` has (1 for zero).
+uint8_t count_digits(uint64_t value);
+
+/**
+ * @brief Write `value` in decimal into `buffer`, which must hold at least
+ *      `TO_STRING_BUF_SZ` bytes, and NUL-terminate it.
+ *
+ *  The number formatters keep no state of their own, so they are safe to
+ *  call from interrupt handlers and from several processors at once.
+ *
+ * @return the number of characters written, not counting the NUL.
+ */
+uint64_t to_string(uint64_t value, char* buffer);
+uint64_t to_string(int64_t value, char* buffer);
+
+inline uint64_t to_string(uint32_t value, char* buffer) {
+    return to_string((uint64_t)value, buffer);
+}
+
+inline uint64_t to_string(uint16_t value, char* buffer) {
+    return to_string((uint64_t)value, buffer);
+}
+
+inline uint64_t to_string(uint8_t value, char* buffer) {
+    return to_string((uint64_t)value, buffer);
+}
+
+inline uint64_t to_string(int32_t value, char* buffer) {
+    return to_string((int64_t)value, buffer);
+}
+
+inline uint64_t to_string(int16_t value, char* buffer) {
+    return to_string((int64_t)value, buffer);
+}
+
+inline uint64_t to_string(int8_t value, char* buffer) {
+    return to_string((int64_t)value, buffer);
+}
+
+/**
+ * @brief Write `value`, rounded to `decimalPlaces` (at most
+ *      `TO_STRING_MAX_DECIMALS`) digits after the point, into `buffer`,
+ *      which must hold at least `TO_STRING_BUF_SZ_DBL` bytes. Values of
+ *      1e19 and up are written as `d.ddde+N`. Either way, ties (judged on
+ *      the exact value of the double) round half up.
+ * @return the number of characters written, not counting the NUL.
+ */
+uint64_t to_string(double value, char* buffer, uint8_t decimalPlaces = 2);
+
+/**
+ * @brief Write all 16 hexadecimal digits of `value` into `buffer`, which
+ *      must hold at least `TO_HEXSTRING_BUF_SZ` bytes.
+ * @return the number of characters written (always 16).
+ */
+uint64_t to_hexstring(uint64_t value, char* buffer, bool capital = false);
+
+inline uint64_t to_hexstring(const void* ptr, char* buffer, bool capital = false) {
+    return to_hexstring((uint64_t)ptr, buffer, capital);
 }
 
 #endif  // !_CSTR_HPP
\ No newline at end of file
@@ -3,8 +3,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <format.hpp>
 #include <string.hpp>
-#include <va_list.hpp>
+#include <string_view.hpp>
 
 enum class ShouldNewline { Yes = 0, No = 1 };
 
@@ -17,56 +18,24 @@ void dbgmsg_s(const char* str);
 // Print a number of bytes from a given buffer as characters.
 void dbgmsg_buf(uint8_t* buffer, uint64_t byteCount);
 
-// Print a single character with an optional newline.
-void dbgmsg(char, ShouldNewline nl = ShouldNewline::No);
-
-// Print a number of bytes from a given
-// buffer as characters with an optional newline.
-void dbgmsg(uint8_t* buffer, uint64_t byteCount, ShouldNewline nl = ShouldNewline::No);
-
-// Print a human readable boolean value with an optional newline.
-void dbgmsg(bool, ShouldNewline nl = ShouldNewline::No);
-
-// Print the raw bytes of a string with an optional newline.
-void dbgmsg(const String&, ShouldNewline nl = ShouldNewline::No);
-
-void dbgmsg(double, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(int64_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(int32_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(int16_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(int8_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(uint64_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(uint32_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(uint16_t, ShouldNewline nl = ShouldNewline::No);
-void dbgmsg(uint8_t, ShouldNewline nl = ShouldNewline::No);
-
-/** 
- *  @brief Print a formatted string.
- *  Supported formats:
- *      %s     -- null terminated C-style string
- *      %c     -- character
- *      %b     -- boolean
- *      %hhu   -- 8 bit unsigned integer
- *      %hu    -- 16 bit unsigned integer
- *      %u     -- native bit width unsigned integer
- *      %ul    -- 32 bit unsigned integer
- *      %ull   -- 64 bit unsigned integer
- *      %hhi   -- 8 bit signed integer
- *      %hi    -- 16 bit signed integer
- *      %i     -- native bit width signed integer
- *      %il    -- 32 bit signed integer
- *      %ill   -- 64 bit signed integer
- *      %f     -- double, 2 digits of precision
- *      %x,%p  -- 16 hexadecimal-digit 64 bit unsigned integer
- *      %sl    -- Eterna `String`
-*/
-void dbgmsg(const char* fmt, ...);
+// Hand a finished piece of `dbgmsg` output to the log sinks, at `Info` level.
+void dbgmsg_sink(StringView);
+
+/**
+ *  @brief Print each argument in turn, formatted according to its type
+ *      (see `format_arg`), e.g.
+ *          dbgmsg("[HEAP]: Expanding by ", numPages, " pages at ", address, "\r\n");
+ *      The whole message is gathered in a buffer on the stack and sent to
+ *      the log sinks at once, in `FORMAT_LINE_SIZE` byte pieces if it is longer.
+ */
+template <typename... Args> void dbgmsg(const Args&... args) {
+    char line[FORMAT_LINE_SIZE];
+    FormatBuffer out(line, sizeof(line), dbgmsg_sink);
+    format(out, args...);
+    out.flush();
+}
 
 // Print a string with lots of colors (and no formatting)! Nyan debug :^)
-void dbgrainbow(const String&, ShouldNewline nl = ShouldNewline::No);
-
-// Print a C-style null-terminated string in lots
-// of colors (and no formatting)! Nyan debug :^)
-void dbgrainbow(const char* str, ShouldNewline nl = ShouldNewline::No);
+void dbgrainbow(StringView, ShouldNewline nl = ShouldNewline::No);
 
 #endif  // !_DEBUG_HPP
\ No newline at end of file
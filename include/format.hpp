@@ -0,0 +1,144 @@
+#ifndef _FORMAT_HPP
+#define _FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string.hpp>
+#include <string_view.hpp>
+
+// Bytes of formatted output gathered before a sink sees any of it.
+#ifndef FORMAT_LINE_SIZE
+#define FORMAT_LINE_SIZE 256
+#endif
+
+// Receives formatted output.
+typedef void (*FormatSink)(StringView);
+
+// Print an integer as `0x` followed by 16 hexadecimal digits.
+struct Hex {
+    uint64_t Value;
+};
+
+constexpr Hex hex(uint64_t value) { return {value}; }
+
+// Print a double with `DecimalPlaces` digits after the point.
+struct Fixed {
+    double Value;
+    uint8_t DecimalPlaces;
+};
+
+constexpr Fixed fixed(double value, uint8_t decimalPlaces) { return {value, decimalPlaces}; }
+
+/**
+ * @brief Gathers formatted output in a caller-provided buffer and hands it
+ *      to `Sink` in as few calls as possible: once on `flush()`, plus once
+ *      whenever the buffer fills up. Pieces are never split across sink
+ *      calls unless they are bigger than the whole buffer, so escape
+ *      sequences within a piece arrive in one go.
+ *
+ *  Without a sink, output that doesn't fit is dropped.
+ */
+class FormatBuffer {
+public:
+    FormatBuffer(char* buffer, uint64_t capacity, FormatSink sink = nullptr)
+        : Buffer(buffer), Capacity(capacity), Sink(sink) {}
+
+    FormatBuffer(const FormatBuffer&) = delete;
+    FormatBuffer& operator=(const FormatBuffer&) = delete;
+
+    void put(char c);
+    void put(const char* data, uint64_t length);
+
+    // Hand everything gathered so far to the sink.
+    void flush();
+
+    uint64_t length() const { return Length; }
+    StringView view() const { return StringView(Buffer, Length); }
+
+private:
+    char* Buffer;
+    uint64_t Capacity;
+    uint64_t Length{0};
+    FormatSink Sink;
+};
+
+/**
+ * @brief Append one value to `out`. The overload picked by the value's
+ *      type decides how it is printed:
+ *      `char`                      -- the character itself
+ *      `bool`                      -- `True` or `False`
+ *      `const char*`, `StringView`, `String` -- the text
+ *      other integers              -- decimal
+ *      `double`, `float`           -- decimal, 2 digits after the point
+ *      `Fixed` (`fixed(v, n)`)     -- decimal, `n` digits after the point
+ *      `Hex` (`hex(v)`), pointers  -- `0x` and 16 hexadecimal digits
+ */
+void format_arg(FormatBuffer& out, char value);
+void format_arg(FormatBuffer& out, bool value);
+void format_arg(FormatBuffer& out, const char* value);
+void format_arg(FormatBuffer& out, StringView value);
+void format_arg(FormatBuffer& out, const String& value);
+void format_arg(FormatBuffer& out, uint64_t value);
+void format_arg(FormatBuffer& out, int64_t value);
+void format_arg(FormatBuffer& out, double value);
+void format_arg(FormatBuffer& out, Fixed value);
+void format_arg(FormatBuffer& out, Hex value);
+void format_arg(FormatBuffer& out, const void* value);
+
+inline void format_arg(FormatBuffer& out, unsigned char value) {
+    format_arg(out, (uint64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, unsigned short value) {
+    format_arg(out, (uint64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, unsigned int value) {
+    format_arg(out, (uint64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, unsigned long long value) {
+    format_arg(out, (uint64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, signed char value) {
+    format_arg(out, (int64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, short value) {
+    format_arg(out, (int64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, int value) {
+    format_arg(out, (int64_t)value);
+}
+
+inline void format_arg(FormatBuffer& out, long long value) {
+    format_arg(out, (int64_t)value);
+}
+
+/**
+ * @brief Append every argument to `out`, in order, each printed according
+ *      to its type (see `format_arg`). Arguments of a type with no
+ *      `format_arg` overload fail to compile.
+ */
+template <typename... Args> void format(FormatBuffer& out, const Args&... args) {
+    (format_arg(out, args), ...);
+}
+
+/**
+ * @brief Format `args` into `buffer`, keeping at most `capacity - 1`
+ *      bytes of output, and NUL-terminate it.
+ * @return the number of bytes written, not counting the NUL.
+ */
+template <typename... Args>
+uint64_t format_to(char* buffer, uint64_t capacity, const Args&... args) {
+    if (capacity == 0) return 0;
+
+    FormatBuffer out(buffer, capacity - 1);
+    format(out, args...);
+    buffer[out.length()] = '\0';
+    return out.length();
+}
+
+#endif  // !_FORMAT_HPP
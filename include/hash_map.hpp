@@ -0,0 +1,342 @@
+#ifndef _HASH_MAP_HPP
+#define _HASH_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory/allocator.hpp>
+#include <memory/heap.hpp>
+#include <memory/memory.hpp>
+#include <string.hpp>
+#include <string_view.hpp>
+#include <utility.hpp>
+
+// Capacity of a hash map's first allocated table; must be a power of two.
+#ifndef HASH_MAP_INITIAL_CAPACITY
+#define HASH_MAP_INITIAL_CAPACITY 16
+#endif
+
+// Tables grow (or, when fixed, refuse inserts) past this load, in eighths.
+#define HASH_MAP_MAX_LOAD_EIGHTHS 7
+
+// Scramble the bits of an integer key so that nearby keys spread out (splitmix64).
+constexpr uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash `numBytes` bytes at `data` (64-bit FNV-1a, then mixed).
+constexpr uint64_t hash_bytes(const char* data, uint64_t numBytes) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint64_t i = 0; i < numBytes; ++i) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash_mix(hash);
+}
+
+// Default hash: integers and enums.
+template <typename K> struct Hash {
+    uint64_t operator()(const K& key) const { return hash_mix((uint64_t)key); }
+};
+
+template <typename T> struct Hash<T*> {
+    uint64_t operator()(T* key) const { return hash_mix((uint64_t)key); }
+};
+
+template <> struct Hash<StringView> {
+    uint64_t operator()(StringView key) const {
+        return hash_bytes(key.data(), key.length());
+    }
+};
+
+template <> struct Hash<String> {
+    uint64_t operator()(const String& key) const {
+        return hash_bytes(key.data(), key.length());
+    }
+};
+
+/**
+ * @brief The table shared by `HashMap` and `FixedHashMap`: open
+ *      addressing with linear probing over a power-of-two number of slots,
+ *      kept in Robin Hood order.
+ *
+ *  Every entry records how far it sits from its home slot, and an insert
+ *  that reaches an entry closer to home than itself takes that slot and
+ *  carries the displaced entry on. This keeps probe sequences short and
+ *  lets a lookup stop as soon as it passes where its key would have been.
+ *  Removal shifts the following entries back a slot, so there are no
+ *  tombstones.
+ */
+template <typename K, typename V, typename H> class HashTable {
+protected:
+    struct Slot {
+        // Probe distance from the home slot plus one; zero when empty.
+        uint32_t Distance;
+        // Low bits of the key's hash, compared before the key itself.
+        uint32_t Hash;
+        alignas(K) uint8_t KeyStorage[sizeof(K)];
+        alignas(V) uint8_t ValueStorage[sizeof(V)];
+
+        K& key() { return *(K*)KeyStorage; }
+        V& value() { return *(V*)ValueStorage; }
+    };
+
+    HashTable() = default;
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+public:
+    uint64_t length() const { return Count; }
+    uint64_t capacity() const { return Capacity; }
+    bool empty() const { return Count == 0; }
+
+    // @return the value stored for `key`, or `nullptr`.
+    V* find(const K& key) {
+        if (Count == 0) return nullptr;
+
+        uint32_t hash = (uint32_t)H()(key);
+        uint64_t index = hash & (Capacity - 1);
+        for (uint32_t distance = 1;; ++distance) {
+            Slot& slot = Slots[index];
+            // Past the point where `key` would have displaced this entry.
+            if (slot.Distance < distance)
+                return nullptr;
+            if (slot.Hash == hash && slot.key() == key)
+                return &slot.value();
+
+            index = (index + 1) & (Capacity - 1);
+        }
+    }
+
+    bool contains(const K& key) { return find(key) != nullptr; }
+
+    bool remove(const K& key) {
+        V* value = find(key);
+        if (value == nullptr) return false;
+
+        // `ValueStorage` is at a fixed offset, so step back to the slot.
+        auto* slot = (Slot*)((uint8_t*)value - offsetof(Slot, ValueStorage));
+        uint64_t index = slot - Slots;
+        slot->key().~K();
+        slot->value().~V();
+
+        // Shift the rest of the cluster back towards its home slots.
+        uint64_t next = (index + 1) & (Capacity - 1);
+        while (Slots[next].Distance > 1) {
+            move_slot(Slots[next], Slots[index]);
+            Slots[index].Distance--;
+            index = next;
+            next = (next + 1) & (Capacity - 1);
+        }
+        Slots[index].Distance = 0;
+
+        Count--;
+        return true;
+    }
+
+    void clear() {
+        for (uint64_t i = 0; i < Capacity; ++i) {
+            if (Slots[i].Distance == 0)
+                continue;
+
+            Slots[i].key().~K();
+            Slots[i].value().~V();
+            Slots[i].Distance = 0;
+        }
+        Count = 0;
+    }
+
+    // Call `callback(const K&, V&)` for every entry, in no particular order.
+    template <typename Callback> void for_each(Callback callback) {
+        for (uint64_t i = 0; i < Capacity; ++i)
+            if (Slots[i].Distance != 0)
+                callback((const K&)Slots[i].key(), Slots[i].value());
+    }
+
+protected:
+    bool over_load(uint64_t count) const {
+        return count * 8 > Capacity * HASH_MAP_MAX_LOAD_EIGHTHS;
+    }
+
+    // Move-construct `to` from `from`, leaving `from` destructed (but not marked empty).
+    static void move_slot(Slot& from, Slot& to) {
+        new (to.KeyStorage) K(move(from.key()));
+        new (to.ValueStorage) V(move(from.value()));
+        to.Distance = from.Distance;
+        to.Hash = from.Hash;
+        from.key().~K();
+        from.value().~V();
+    }
+
+    static void mark_empty(Slot* slots, uint64_t capacity) {
+        for (uint64_t i = 0; i < capacity; ++i)
+            slots[i].Distance = 0;
+    }
+
+    /**
+     * @brief Store `value` for `key`, replacing any value already there.
+     *      The caller makes sure there is room for one more entry.
+     * @return where the value ended up.
+     */
+    V* place(uint32_t hash, K key, V value) {
+        uint64_t index = hash & (Capacity - 1);
+        V* placed = nullptr;
+        for (uint32_t distance = 1;; ++distance) {
+            Slot& slot = Slots[index];
+            if (slot.Distance == 0) {
+                new (slot.KeyStorage) K(move(key));
+                new (slot.ValueStorage) V(move(value));
+                slot.Distance = distance;
+                slot.Hash = hash;
+                Count++;
+                return placed ? placed : &slot.value();
+            }
+
+            if (placed == nullptr && slot.Hash == hash && slot.key() == key) {
+                slot.value() = move(value);
+                return &slot.value();
+            }
+
+            // Rich entry: take its slot and carry it further along instead.
+            if (slot.Distance < distance) {
+                swap(slot.key(), key);
+                swap(slot.value(), value);
+                swap(slot.Hash, hash);
+                uint32_t carried = slot.Distance;
+                slot.Distance = distance;
+                distance = carried;
+                if (placed == nullptr)
+                    placed = &slot.value();
+            }
+
+            index = (index + 1) & (Capacity - 1);
+        }
+    }
+
+    Slot* Slots{nullptr};
+    uint64_t Capacity{0};
+    uint64_t Count{0};
+};
+
+/**
+ * @brief A growable map from `K` to `V`. The table comes from `Alloc` and
+ *      doubles once it is 7/8 full.
+ *
+ * @note Pointers to values are invalidated by inserting and removing.
+ */
+template <typename K, typename V, typename H = Hash<K>>
+class HashMap : public HashTable<K, V, H> {
+    typedef HashTable<K, V, H> Base;
+    typedef typename Base::Slot Slot;
+
+public:
+    HashMap() = default;
+
+    // Allocate from `allocator` instead of the heap (see `Allocator`).
+    explicit HashMap(Allocator* allocator) : Alloc(allocator) {}
+
+    ~HashMap() {
+        this->clear();
+        if (this->Slots)
+            deallocate(Alloc, this->Slots);
+    }
+
+    /**
+     * @brief Store `value` for `key`, replacing any value already there.
+     * @return the stored value, or `nullptr` if the table could not grow.
+     */
+    V* set(const K& key, V value) {
+        if (this->over_load(this->Count + 1) && !grow(this->Capacity * 2))
+            return nullptr;
+
+        return this->place((uint32_t)H()(key), key, move(value));
+    }
+
+    // Make room for `count` entries without growing.
+    bool reserve(uint64_t count) {
+        uint64_t capacity = this->Capacity;
+        while (capacity * HASH_MAP_MAX_LOAD_EIGHTHS < count * 8)
+            capacity = capacity ? capacity * 2 : HASH_MAP_INITIAL_CAPACITY;
+
+        return capacity == this->Capacity || grow(capacity);
+    }
+
+    Allocator* allocator() const { return Alloc; }
+
+private:
+    bool grow(uint64_t capacity) {
+        if (capacity < HASH_MAP_INITIAL_CAPACITY)
+            capacity = HASH_MAP_INITIAL_CAPACITY;
+
+        auto* slots = (Slot*)allocate(Alloc, capacity * sizeof(Slot));
+        if (slots == nullptr) return false;
+        this->mark_empty(slots, capacity);
+
+        Slot* oldSlots = this->Slots;
+        uint64_t oldCapacity = this->Capacity;
+        this->Slots = slots;
+        this->Capacity = capacity;
+        this->Count = 0;
+
+        for (uint64_t i = 0; i < oldCapacity; ++i) {
+            Slot& slot = oldSlots[i];
+            if (slot.Distance == 0)
+                continue;
+
+            this->place(slot.Hash, move(slot.key()), move(slot.value()));
+            slot.key().~K();
+            slot.value().~V();
+        }
+
+        if (oldSlots)
+            deallocate(Alloc, oldSlots);
+        return true;
+    }
+
+    // `nullptr` means the heap.
+    Allocator* Alloc{nullptr};
+};
+
+/**
+ * @brief A map from `K` to `V` stored entirely inside the object, with
+ *      room for `SlotCount` slots (a power of two). Never allocates, so it
+ *      may be used from interrupt context.
+ */
+template <typename K, typename V, uint64_t SlotCount, typename H = Hash<K>>
+class FixedHashMap : public HashTable<K, V, H> {
+    typedef HashTable<K, V, H> Base;
+    typedef typename Base::Slot Slot;
+
+    static_assert(SlotCount && (SlotCount & (SlotCount - 1)) == 0,
+                  "FixedHashMap slot count must be a power of two");
+
+public:
+    FixedHashMap() {
+        this->Slots = (Slot*)Storage;
+        this->Capacity = SlotCount;
+        this->mark_empty(this->Slots, SlotCount);
+    }
+
+    ~FixedHashMap() { this->clear(); }
+
+    /**
+     * @brief Store `value` for `key`, replacing any value already there.
+     * @return the stored value, or `nullptr` if the map is full.
+     */
+    V* set(const K& key, V value) {
+        if (this->over_load(this->Count + 1) && this->find(key) == nullptr)
+            return nullptr;
+
+        return this->place((uint32_t)H()(key), key, move(value));
+    }
+
+private:
+    alignas(Slot) uint8_t Storage[SlotCount * sizeof(Slot)];
+};
+
+#endif  // !_HASH_MAP_HPP
@@ -125,7 +125,7 @@ void cause_nullptr_dereference();
 
 void remap_pic();
 
-// Enable IRQx within the PIC masks.
+// Enable IRQx within the PIC masks (and the cascade line, for IRQ8-15).
 void enable_interrupt(uint8_t irq);
 // Disable IRQx within the PIC masks.
 void disable_interrupt(uint8_t irq);
@@ -0,0 +1,148 @@
+#ifndef _INTRUSIVE_LIST_HPP
+#define _INTRUSIVE_LIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility.hpp>
+
+/**
+ * @brief Links embedded in an object so that it can be put on an
+ *      `IntrusiveList` without allocating. An object may be on as many
+ *      lists at once as it has nodes.
+ */
+struct ListNode {
+    ListNode* Prev{nullptr};
+    ListNode* Next{nullptr};
+
+    bool linked() const { return Next != nullptr; }
+};
+
+/**
+ * @brief A doubly linked list of `T`s, threaded through their `Member`
+ *      nodes. The list never owns, allocates or frees its elements;
+ *      insertion and removal are O(1).
+ *
+ *  Usage:
+ *      struct Timer { uint64_t Deadline; ListNode Link; };
+ *      IntrusiveList<Timer, &Timer::Link> timers;
+ *
+ * @note The list is circular through a sentinel stored in the list
+ *      object itself, so the list must not be moved or copied.
+ */
+template <typename T, ListNode T::*Member> class IntrusiveList {
+public:
+    IntrusiveList() {
+        Head.Prev = &Head;
+        Head.Next = &Head;
+    }
+
+    // Elements still on the list are unlinked, not destructed.
+    ~IntrusiveList() { clear(); }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    bool empty() const { return Head.Next == &Head; }
+    uint64_t length() const { return Length; }
+
+    T* front() { return empty() ? nullptr : owner(Head.Next); }
+    T* back() { return empty() ? nullptr : owner(Head.Prev); }
+
+    void push_front(T& item) { link(node(item), &Head, Head.Next); }
+    void push_back(T& item) { link(node(item), Head.Prev, &Head); }
+
+    // Insert `item` directly before `position`, which must be on this list.
+    void insert_before(T& position, T& item) {
+        ListNode* next = node(position);
+        link(node(item), next->Prev, next);
+    }
+
+    // Insert `item` directly after `position`, which must be on this list.
+    void insert_after(T& position, T& item) {
+        ListNode* prev = node(position);
+        link(node(item), prev, prev->Next);
+    }
+
+    // Unlink `item`, which must be on this list.
+    void remove(T& item) {
+        ListNode* n = node(item);
+        n->Prev->Next = n->Next;
+        n->Next->Prev = n->Prev;
+        n->Prev = nullptr;
+        n->Next = nullptr;
+        Length--;
+    }
+
+    T* pop_front() {
+        T* item = front();
+        if (item) remove(*item);
+        return item;
+    }
+
+    T* pop_back() {
+        T* item = back();
+        if (item) remove(*item);
+        return item;
+    }
+
+    // @return the element after `item`, or `nullptr` at the end of the list.
+    T* next(T& item) {
+        ListNode* n = node(item)->Next;
+        return n == &Head ? nullptr : owner(n);
+    }
+
+    // @return the element before `item`, or `nullptr` at the start of the list.
+    T* prev(T& item) {
+        ListNode* n = node(item)->Prev;
+        return n == &Head ? nullptr : owner(n);
+    }
+
+    // Unlink every element.
+    void clear() {
+        while (!empty())
+            pop_front();
+    }
+
+    class Iterator {
+    public:
+        explicit Iterator(ListNode* node) : Node(node) {}
+
+        T& operator*() const { return *owner(Node); }
+        T* operator->() const { return owner(Node); }
+
+        Iterator& operator++() {
+            Node = Node->Next;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const { return Node != other.Node; }
+        bool operator==(const Iterator& other) const { return Node == other.Node; }
+
+    private:
+        ListNode* Node;
+    };
+
+    /**
+     * @note Removing the element an iterator is on invalidates it; use
+     *      `next()` to walk the list while removing.
+     */
+    Iterator begin() { return Iterator(Head.Next); }
+    Iterator end() { return Iterator(&Head); }
+
+private:
+    static ListNode* node(T& item) { return &(item.*Member); }
+    static T* owner(ListNode* n) { return owner_of(n, Member); }
+
+    void link(ListNode* n, ListNode* prev, ListNode* next) {
+        n->Prev = prev;
+        n->Next = next;
+        prev->Next = n;
+        next->Prev = n;
+        Length++;
+    }
+
+    ListNode Head;
+    uint64_t Length{0};
+};
+
+#endif  // !_INTRUSIVE_LIST_HPP
@@ -0,0 +1,44 @@
+#ifndef _PIT_HPP
+#define _PIT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Programmable Interval Timer input clock, in Hz.
+#define PIT_FREQUENCY 1193182
+
+#define PIT_CHANNEL0 0x40
+#define PIT_CHANNEL2 0x42
+#define PIT_COMMAND 0x43
+// Bit 0 gates channel 2, bit 1 connects it to the speaker, bit 5 reads its output.
+#define PIT_CHANNEL2_CONTROL 0x61
+
+// Command bits: channel (7-6), access mode (5-4), operating mode (3-1).
+#define PIT_SELECT_CHANNEL0 (0 << 6)
+#define PIT_SELECT_CHANNEL2 (2 << 6)
+#define PIT_ACCESS_LOW_HIGH (3 << 4)
+#define PIT_MODE_INTERRUPT_ON_TERMINAL_COUNT (0 << 1)
+#define PIT_MODE_RATE_GENERATOR (2 << 1)
+
+// How long `PIT::measure_tsc_frequency()` counts for, in milliseconds.
+#ifndef PIT_CALIBRATION_MS
+#define PIT_CALIBRATION_MS 10
+#endif
+
+namespace PIT {
+/**
+ * @brief Make channel 0 raise IRQ0 `hz` times a second (as near as its
+ *      16-bit divisor allows, so 19 Hz at the least).
+ * @return the frequency actually programmed.
+ */
+uint32_t set_periodic(uint32_t hz);
+
+/**
+ * @brief Count TSC ticks while channel 2 counts down `PIT_CALIBRATION_MS`.
+ *      Leaves the speaker off and channel 0 alone.
+ * @return the TSC frequency in Hz, or 0 if channel 2 never finished.
+ */
+uint64_t measure_tsc_frequency();
+}  // namespace PIT
+
+#endif  // !_PIT_HPP
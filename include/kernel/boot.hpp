@@ -13,6 +13,12 @@ struct BootInfo {
     uint64_t mapSize;
     uint64_t mapDescSize;
     void* RSDP;
+    // Time-stamp counter on entering the bootloader and just before jumping
+    //   to the kernel, or zero if the bootloader didn't record them.
+    uint64_t loaderStart;
+    uint64_t loaderExit;
 };
 
+static_assert(sizeof(BootInfo) == 64, "prekernel.asm copies BootInfo by size");
+
 #endif // !_BOOT_HPP
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef _BOOT_CHART_HPP
+#define _BOOT_CHART_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <kernel/boot.hpp>
+
+// Most phases `BootChart::mark()` records; later ones are ignored.
+#ifndef BOOT_CHART_MAX_PHASES
+#define BOOT_CHART_MAX_PHASES 24
+#endif
+
+namespace BootChart {
+// Note the time-stamp counter as the start of the first phase.
+void begin();
+
+/**
+ * @brief Note the time-stamp counter as the end of `phase` (a string
+ *      literal) and the start of the next one.
+ */
+void mark(const char* phase);
+
+/**
+ * @brief Print how long the bootloader (if it recorded timestamps in
+ *      `bInfo`) and each phase took, in microseconds once the TSC is
+ *      calibrated and in ticks until then.
+ */
+void print(const BootInfo* bInfo);
+}  // namespace BootChart
+
+#endif  // !_BOOT_CHART_HPP
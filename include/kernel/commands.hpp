@@ -0,0 +1,51 @@
+#ifndef _COMMANDS_HPP
+#define _COMMANDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view.hpp>
+
+// Most commands that may be registered at once.
+#ifndef COMMANDS_MAX
+#define COMMANDS_MAX 16
+#endif
+
+// Longest line of COM1 input a command can be given.
+#define COMMAND_LINE_SIZE 128
+
+/**
+ * @brief Something that can be run by typing `Name` (and any arguments,
+ *      which `Run` receives with the name and following spaces removed)
+ *      followed by Enter over COM1.
+ */
+struct Command {
+    const char* Name;
+    // One line of usage, shown by `help`.
+    const char* Usage;
+    void (*Run)(StringView arguments);
+};
+
+namespace Commands {
+// Make `command` available. @return false if the registry is full.
+bool add(const Command* command);
+
+/**
+ * @brief Take bytes of COM1 input, echoing them back, and run each
+ *      command line as it is completed.
+ */
+void feed(const uint8_t* input, uint64_t count);
+
+/**
+ * @return the word of `text` starting at `position` (after skipping
+ *      spaces), and advance `position` past it.
+ */
+StringView next_word(StringView text, uint64_t& position);
+
+/**
+ * @brief Read `text` as an unsigned decimal number into `value`.
+ * @return false if `text` is empty or holds anything but digits.
+ */
+bool parse_number(StringView text, uint64_t& value);
+}  // namespace Commands
+
+#endif  // !_COMMANDS_HPP
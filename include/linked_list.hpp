@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory/allocator.hpp>
 #include <memory/heap.hpp>
 
 template <typename T> class SinglyLinkedList;
@@ -30,16 +31,21 @@ template <typename T> class SinglyLinkedList {
     typedef SinglyLinkedListNode<DataType> Node;
 
 public:
+    SinglyLinkedList() = default;
+
+    // Allocate nodes from `allocator` instead of the heap (see `Allocator`).
+    explicit SinglyLinkedList(Allocator* allocator) : Alloc(allocator) {}
+
     ~SinglyLinkedList() {
         while (Head) {
             Node* tmp = Head;
             Head = Head->Next;
-            delete tmp;
+            destroy_node(tmp);
         }
     }
 
     void add(const DataType& value) {
-        auto* newHead = new Node(value, Head);
+        auto* newHead = create_node(value, Head);
         if (newHead != nullptr) {
             Head = newHead;
             if (Tail == nullptr) Tail = Head;
@@ -52,9 +58,9 @@ public:
     void add_end(const DataType& value) {
         // Handle empty list case.
         if (Head == nullptr) {
-            ass(value);
+            add(value);
         } else {
-            auto* newTail = new Node(value, nullptr);
+            auto* newTail = create_node(value, nullptr);
 
             if (newTail != nullptr) {
                 // Prevent nullptr dereference.
@@ -101,7 +107,7 @@ public:
                 Node* old = Head;
                 Head = Head->next();
                 Length--;
-                delete old;
+                destroy_node(old);
             } else {  // if head is nullptr, ensure tail is as well
                 Tail = nullptr;
             }
@@ -130,7 +136,7 @@ public:
 
         prev->Next = next;
         Length--;
-        delete current;
+        destroy_node(current);
 
         return true;
     }
@@ -148,9 +154,23 @@ public:
     const DataType& operator[](uint64_t index) const { return at(index); }
 
 private:
+    Node* create_node(const DataType& value, Node* next) {
+        void* memory = allocate(Alloc, sizeof(Node));
+        if (memory == nullptr) return nullptr;
+
+        return new (memory) Node(value, next);
+    }
+
+    void destroy_node(Node* node) {
+        node->~Node();
+        deallocate(Alloc, node);
+    }
+
     uint64_t Length{0};
     Node* Head{nullptr};
     Node* Tail{nullptr};
+    // `nullptr` means the heap.
+    Allocator* Alloc{nullptr};
 };
 
 #endif  // !_LINKED_LIST_HPP
\ No newline at end of file
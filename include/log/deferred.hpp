@@ -0,0 +1,197 @@
+#ifndef _LOG_DEFERRED_HPP
+#define _LOG_DEFERRED_HPP
+
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <format.hpp>
+#include <log/log.hpp>
+#include <ring_buffer.hpp>
+
+// Records each processor can hold before the flush catches up (a power of two).
+#ifndef DEFERRED_LOG_SLOTS
+#define DEFERRED_LOG_SLOTS 256
+#endif
+
+// Most arguments one deferred record can carry.
+#define DEFERRED_LOG_MAX_ARGS 6
+
+// How a raw argument of a deferred record is printed.
+enum class DeferredArgType : uint8_t {
+    Unsigned = 0,
+    Signed,
+    Hex,
+    Char,
+    Bool,
+    Double,
+    String,
+};
+
+struct DeferredArg {
+    DeferredArgType Type;
+    uint64_t Bits;
+};
+
+/**
+ * @brief One message, as logged: formatting is left to whoever flushes
+ *      it, so writing one is a handful of stores.
+ */
+struct DeferredLogRecord {
+    // `CPU::rdtsc()` when the message was logged.
+    uint64_t Timestamp;
+    // Text with a `{}` wherever the next argument goes; must outlive the record.
+    const char* Format;
+    LogLevel Level;
+    uint8_t ArgCount;
+    DeferredArgType ArgTypes[DEFERRED_LOG_MAX_ARGS];
+    uint64_t Args[DEFERRED_LOG_MAX_ARGS];
+};
+
+/**
+ * @brief Capture one argument of a deferred record by value. Only types
+ *      that can be printed later without looking anything up are
+ *      accepted; strings are kept by pointer, so only pass ones that
+ *      outlive the record (string literals, static tables).
+ *
+ *  These and `Log::defer()` are `static` so that interrupt handlers, which
+ *  are built without vector registers, get their own copies rather than
+ *  the linker picking one shared with the rest of the kernel.
+ */
+static inline DeferredArg deferred_arg(uint64_t value) {
+    return {DeferredArgType::Unsigned, value};
+}
+
+static inline DeferredArg deferred_arg(int64_t value) {
+    return {DeferredArgType::Signed, (uint64_t)value};
+}
+
+static inline DeferredArg deferred_arg(unsigned char value) {
+    return deferred_arg((uint64_t)value);
+}
+
+static inline DeferredArg deferred_arg(unsigned short value) {
+    return deferred_arg((uint64_t)value);
+}
+
+static inline DeferredArg deferred_arg(unsigned int value) {
+    return deferred_arg((uint64_t)value);
+}
+
+static inline DeferredArg deferred_arg(unsigned long long value) {
+    return deferred_arg((uint64_t)value);
+}
+
+static inline DeferredArg deferred_arg(signed char value) {
+    return deferred_arg((int64_t)value);
+}
+
+static inline DeferredArg deferred_arg(short value) {
+    return deferred_arg((int64_t)value);
+}
+
+static inline DeferredArg deferred_arg(int value) {
+    return deferred_arg((int64_t)value);
+}
+
+static inline DeferredArg deferred_arg(long long value) {
+    return deferred_arg((int64_t)value);
+}
+
+static inline DeferredArg deferred_arg(char value) {
+    return {DeferredArgType::Char, (uint8_t)value};
+}
+
+static inline DeferredArg deferred_arg(bool value) {
+    return {DeferredArgType::Bool, value};
+}
+
+static inline DeferredArg deferred_arg(double value) {
+    return {DeferredArgType::Double, __builtin_bit_cast(uint64_t, value)};
+}
+
+static inline DeferredArg deferred_arg(Hex value) {
+    return {DeferredArgType::Hex, value.Value};
+}
+
+static inline DeferredArg deferred_arg(const void* value) {
+    return {DeferredArgType::Hex, (uint64_t)value};
+}
+
+static inline DeferredArg deferred_arg(const char* value) {
+    return {DeferredArgType::String, (uint64_t)value};
+}
+
+/**
+ * Records logged on one processor. Only that processor pushes, but an
+ *  interrupt may push in the middle of another push, hence the
+ *  multi-producer ring.
+ */
+struct DeferredLog {
+    RingBuffer<DeferredLogRecord, DEFERRED_LOG_SLOTS, true> Records;
+    // Records lost to a full ring since the last flush.
+    uint64_t Dropped{0};
+};
+
+extern DeferredLog gDeferredLogs[CPU_MAX_COUNT];
+
+namespace Log {
+// Queue `record` on this processor's ring, or count it as dropped if that is full.
+void push_deferred(const DeferredLogRecord& record);
+
+/**
+ * @brief Record a message to be formatted and written to the sinks by a
+ *      later `flush_deferred()`. Safe anywhere, including interrupt
+ *      handlers: it neither formats, locks nor allocates, and what it
+ *      calls is built without vector registers.
+ */
+template <typename... Values>
+static __attribute__((noinline)) void defer(LogLevel level, const char* format, const Values&... args) {
+    // (`Args` would shadow the record's member of the same name.)
+    static_assert(sizeof...(Values) <= DEFERRED_LOG_MAX_ARGS, "Too many deferred log arguments");
+
+    DeferredLogRecord record;
+    record.Timestamp = CPU::rdtsc();
+    record.Format = format;
+    record.Level = level;
+    record.ArgCount = sizeof...(Values);
+
+    // One spare element, so that there is an array even without arguments.
+    const DeferredArg captured[] = {deferred_arg(args)..., {}};
+    for (uint8_t i = 0; i != sizeof...(Values); ++i) {
+        record.ArgTypes[i] = captured[i].Type;
+        record.Args[i] = captured[i].Bits;
+    }
+
+    push_deferred(record);
+}
+
+/**
+ * @brief Format every queued record, oldest first on each processor, and
+ *      write it to the sinks, preceded by its timestamp. Does nothing if
+ *      another flush is already running. Called from the idle loop.
+ */
+void flush_deferred();
+
+/**
+ * @brief Flush every queued record even if a flush was interrupted part
+ *      way through. Only for panics, where nothing will run again.
+ */
+void drain_deferred();
+}  // namespace Log
+
+/**
+ * @brief Like `LOG`, but the message is only recorded here (in a few
+ *      nanoseconds) and formatted later by `Log::flush_deferred()`. The
+ *      first argument after the level is the format, with `{}` for each
+ *      argument that follows, e.g.
+ *          LOG_DEFERRED(Heap, Trace, "[HEAP]: malloc() -- numBytes={}\r\n", numBytes);
+ */
+#define LOG_DEFERRED(subsystem, level, ...)                                            \
+    do {                                                                               \
+        if constexpr (LogLevel::level >= LOG_LEVEL) {                                  \
+            if (LOG_ENABLED(subsystem, level))                                         \
+                Log::defer(LogLevel::level, __VA_ARGS__);                              \
+        }                                                                              \
+    } while (0)
+
+#endif  // !_LOG_DEFERRED_HPP
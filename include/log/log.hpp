@@ -0,0 +1,138 @@
+#ifndef _LOG_HPP
+#define _LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <format.hpp>
+#include <string_view.hpp>
+
+// Most sinks that may be registered at once.
+#ifndef LOG_MAX_SINKS
+#define LOG_MAX_SINKS 8
+#endif
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    // A sink at this level receives nothing.
+    None,
+};
+
+// @return the name of `level`, e.g. "Warning".
+const char* log_level_name(LogLevel level);
+
+/**
+ * Messages below this level are compiled out of `LOG`. Set with the
+ *  `LOG_LEVEL` CMake option.
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LogLevel::Info
+#endif
+
+// Parts of the kernel whose messages can be turned on and off separately.
+enum class LogSubsystem : uint8_t {
+    Kernel = 0,
+    UART,
+    PMM,
+    VMM,
+    Heap,
+    Count,
+};
+
+// @return the name of `subsystem`, e.g. "PMM".
+const char* log_subsystem_name(LogSubsystem subsystem);
+
+/**
+ * @brief A destination for log output. A sink receives every message at
+ *      or above its `Level`, in pieces that may contain ANSI color codes;
+ *      a message may span several pieces and a piece several lines.
+ *
+ *  `Write` may be called from interrupt handlers, so it must not allocate
+ *  or block on anything an interrupt could be holding, and must not touch
+ *  anything that isn't reentrant (like the renderer) while IF is clear.
+ */
+struct LogSink {
+    const char* Name;
+    void (*Write)(LogLevel level, StringView text);
+    LogLevel Level;
+};
+
+namespace Log {
+/**
+ * @brief Register the built-in sinks: the UART, the in-memory log and,
+ *      under QEMU, the debug console. Call once the UART is initialized.
+ *      The framebuffer console is registered by `console_initialize()`.
+ */
+void initialize();
+
+// Start sending messages to `sink`. @return false if the registry is full.
+bool add_sink(LogSink* sink);
+
+// Stop sending messages to `sink`.
+void remove_sink(LogSink* sink);
+
+// @return the registered sink called `name`, or `nullptr`.
+LogSink* find_sink(StringView name);
+
+// Change which messages `sink` receives; don't assign `Level` directly.
+void set_level(LogSink* sink, LogLevel level);
+
+// @return whether any registered sink takes messages at `level`.
+bool enabled(LogLevel level);
+
+// Hand `text` to every sink that takes messages at `level`.
+void write(LogLevel level, StringView text);
+
+/**
+ * One bit per level (`1 << level`) for each subsystem, set for the levels
+ *  `LOG` lets through. Everything compiled in starts out enabled.
+ */
+extern uint8_t gMasks[(uint8_t)LogSubsystem::Count];
+
+// Let through messages from `subsystem` at `minimum` and above only.
+void set_mask(LogSubsystem subsystem, LogLevel minimum);
+
+template <LogLevel Level> void level_sink(StringView text) {
+    write(Level, text);
+}
+
+// Kept out of line so that a disabled `LOG` costs its call site nothing but a branch.
+template <LogLevel Level, typename... Args>
+__attribute__((noinline)) void print(const Args&... args) {
+    char line[FORMAT_LINE_SIZE];
+    FormatBuffer out(line, sizeof(line), level_sink<Level>);
+    format(out, args...);
+    out.flush();
+}
+}  // namespace Log
+
+/**
+ * @brief Whether `LOG(subsystem, level, ...)` would print: always false
+ *      below `LOG_LEVEL`, otherwise one load and test of the subsystem's
+ *      mask. For guarding work done only to produce log output.
+ */
+#define LOG_ENABLED(subsystem, level)                                                  \
+    (LogLevel::level >= LOG_LEVEL &&                                                   \
+     __builtin_expect((Log::gMasks[(uint8_t)LogSubsystem::subsystem] >>                \
+                       (uint8_t)LogLevel::level) & 1, 0))
+
+/**
+ * @brief Format the remaining arguments like `dbgmsg` and log them at
+ *      `level` on behalf of `subsystem`, e.g.
+ *          LOG(Heap, Trace, "[HEAP]: free() -- address=", address, "\r\n");
+ *      Below `LOG_LEVEL` the statement compiles to nothing (though its
+ *      arguments must still compile); otherwise it costs a single, normally
+ *      not-taken branch unless `Log::gMasks` enables it.
+ */
+#define LOG(subsystem, level, ...)                                                     \
+    do {                                                                               \
+        if constexpr (LogLevel::level >= LOG_LEVEL) {                                  \
+            if (LOG_ENABLED(subsystem, level))                                         \
+                Log::print<LogLevel::level>(__VA_ARGS__);                              \
+        }                                                                              \
+    } while (0)
+
+#endif  // !_LOG_HPP
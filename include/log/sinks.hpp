@@ -0,0 +1,67 @@
+#ifndef _LOG_SINKS_HPP
+#define _LOG_SINKS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <log/log.hpp>
+#include <math.hpp>
+
+// Bytes of recent log output kept in memory (a power of two).
+#ifndef LOG_MEMORY_SIZE
+#define LOG_MEMORY_SIZE 0x10000
+#endif
+
+static_assert(LOG_MEMORY_SIZE && (LOG_MEMORY_SIZE & (LOG_MEMORY_SIZE - 1)) == 0,
+              "LOG_MEMORY_SIZE must be a power of two");
+
+// "ETRNALOG", so the in-memory log can be found in a memory dump.
+#define LOG_MEMORY_MAGIC 0x474f4c414e525445ULL
+
+// QEMU copies bytes written to this port to the `-debugcon` character device.
+#define DEBUGCON_PORT 0xe9
+
+/**
+ * @brief The most recent `LOG_MEMORY_SIZE` bytes of log output, oldest
+ *      overwritten first. Byte `i` of the output (counting from boot)
+ *      lives at `Data[i % LOG_MEMORY_SIZE]`, and `Written` counts every
+ *      byte ever logged, so after a crash the tail of the log can be
+ *      recovered from a debugger or memory dump as well as `read_memory()`.
+ */
+struct MemoryLog {
+    uint64_t Magic;
+    uint64_t Written;
+    char Data[LOG_MEMORY_SIZE];
+};
+
+extern MemoryLog gMemoryLog;
+
+namespace Log {
+// Serial port, default `Info`.
+extern LogSink gUARTSink;
+// QEMU debug console (port `0xe9`), default `Trace`.
+extern LogSink gDebugconSink;
+// `gMemoryLog`, default `Trace`.
+extern LogSink gMemorySink;
+// Text console on the framebuffer, default `Warning`. Drops what is
+// written with interrupts disabled, as in an interrupt handler.
+extern LogSink gConsoleSink;
+
+// Write `count` bytes to the QEMU debug console as they are, in one `rep outsb`.
+void write_debugcon(const void* data, uint64_t count);
+
+/**
+ * @brief Copy the most recent `maxBytes` bytes of the in-memory log (or
+ *      all of it, if there is less) into `buffer`, oldest first.
+ * @return the number of bytes copied.
+ */
+uint64_t read_memory(char* buffer, uint64_t maxBytes);
+
+/**
+ * @brief Show log output in the `size` pixel region of the screen at
+ *      `position`, and register the console sink. The region is cleared
+ *      whenever it fills up. Call once `gRend` is set up.
+ */
+void console_initialize(Vector2<uint64_t> position, Vector2<uint64_t> size);
+}  // namespace Log
+
+#endif  // !_LOG_SINKS_HPP
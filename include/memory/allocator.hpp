@@ -0,0 +1,37 @@
+#ifndef _ALLOCATOR_HPP
+#define _ALLOCATOR_HPP
+
+#include <cstdint>
+#include <memory/heap.hpp>
+
+/**
+ * @brief A hook that lets containers allocate from somewhere other than
+ *      the general purpose heap (an `Arena`, an `ObjectPool`, etc).
+ *      `Context` is passed back to both callbacks untouched.
+ *
+ * A container that is handed `nullptr` instead of an allocator uses the heap.
+ */
+struct Allocator {
+    void* (*Allocate)(void* context, uint64_t numBytes){nullptr};
+    void (*Free)(void* context, void* address){nullptr};
+    void* Context{nullptr};
+};
+
+inline void* allocate(Allocator* allocator, uint64_t numBytes) {
+    if (allocator == nullptr)
+        return malloc(numBytes);
+
+    return allocator->Allocate(allocator->Context, numBytes);
+}
+
+inline void deallocate(Allocator* allocator, void* address) {
+    if (allocator == nullptr) {
+        free(address);
+        return;
+    }
+
+    if (allocator->Free)
+        allocator->Free(allocator->Context, address);
+}
+
+#endif  // !_ALLOCATOR_HPP
@@ -0,0 +1,93 @@
+#ifndef _ARENA_HPP
+#define _ARENA_HPP
+
+#include <cstdint>
+#include <memory/allocator.hpp>
+#include <memory/common.hpp>
+
+/**
+ * @brief A bump-pointer allocator for objects that all die together.
+ *
+ *  Memory is handed out from a chain of page-sized chunks requested
+ *  straight from the physical memory manager (optionally preceded by a
+ *  caller-provided buffer, e.g. on the stack). Individual allocations are
+ *  never freed; instead `reset()` rewinds the whole arena in O(1) while
+ *  keeping its chunks around for reuse, and `release()` (or destruction)
+ *  hands the chunks back.
+ *
+ * @note Destructors of objects placed in an arena are not run.
+ */
+class Arena {
+public:
+    Arena() { init_allocator(); }
+
+    /**
+     * @brief Bump-allocate from `buffer` first; chunks are only
+     *      requested once it has been used up.
+     */
+    Arena(void* buffer, uint64_t numBytes)
+        : InitialBuffer((uint8_t*)buffer), InitialSize(numBytes) {
+        init_allocator();
+        reset();
+    }
+
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @return the address of `numBytes` of memory aligned to `alignment`
+     *      (a power of two), or `nullptr` if no memory is available.
+     */
+    void* allocate(uint64_t numBytes, uint64_t alignment = 8);
+
+    template <typename T> T* allocate_array(uint64_t count) {
+        return (T*)allocate(count * sizeof(T), alignof(T));
+    }
+
+    // Forget every allocation made so far, keeping all chunks for reuse.
+    void reset();
+
+    // Forget every allocation made so far and free all chunks.
+    void release();
+
+    // Number of bytes handed out since the last reset (including padding).
+    uint64_t used() const { return Used; }
+
+    // Number of bytes currently held in chunks.
+    uint64_t reserved() const { return Reserved; }
+
+    /**
+     * @return a hook that allocates from this arena; freeing through it
+     *      is a no-op, as memory is only reclaimed by `reset()`.
+     */
+    Allocator* allocator() { return &Hook; }
+
+private:
+    struct Chunk {
+        Chunk* Next;
+        uint64_t NumPages;
+    };
+
+    void init_allocator();
+    bool advance(uint64_t numBytes, uint64_t alignment);
+
+    uint8_t* InitialBuffer{nullptr};
+    uint64_t InitialSize{0};
+
+    // Chunks are kept in the order they are used in.
+    Chunk* First{nullptr};
+    // Chunk currently being bump-allocated from; `nullptr` while in the initial buffer.
+    Chunk* Current{nullptr};
+
+    uint8_t* Cursor{nullptr};
+    uint8_t* End{nullptr};
+
+    uint64_t Used{0};
+    uint64_t Reserved{0};
+
+    Allocator Hook;
+};
+
+#endif  // !_ARENA_HPP
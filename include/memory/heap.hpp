@@ -3,10 +3,64 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <memory/common.hpp>
+
+struct Command;
 
 #define HEAP_VIRTUAL_BASE 0xffffffffff000000
 #define HEAP_INITIAL_PAGES 1
 
+/**
+ * Large allocations:
+ *  Requests of at least `HEAP_LARGE_ALLOCATION_THRESHOLD` bytes bypass the
+ *  segment list entirely. They are given whole pages, mapped within their
+ *  own virtual range, and are unmapped again as soon as they are freed.
+ *  Each one occupies a slot in a fixed-size side table that records its
+ *  size. A freed range is reused by later requests that fit in it; if
+ *  no slot is free to record what is left over, the whole range is
+ *  handed out and the excess stays unmapped until it is freed again.
+ *  Only when no freed range fits and either the table is full or the
+ *  range is exhausted does the request fall back to the segment heap.
+ */
+#define HEAP_LARGE_VIRTUAL_BASE 0xffffff0000000000
+#define HEAP_LARGE_VIRTUAL_SIZE GiB(64)
+#define HEAP_LARGE_ALLOCATION_SLOTS 128
+
+#ifndef HEAP_LARGE_ALLOCATION_THRESHOLD
+#define HEAP_LARGE_ALLOCATION_THRESHOLD KiB(64)
+#endif
+
+/**
+ * Heap expansion policy:
+ *  Each expansion maps at least twice as many pages as the one before,
+ *  starting at `HEAP_INITIAL_PAGES` and capped at `HEAP_EXPANSION_MAX_PAGES`,
+ *  so a burst of allocations grows the heap in a handful of steps rather
+ *  than one page at a time. Trimming the heap halves the step again.
+ */
+#ifndef HEAP_EXPANSION_MAX_PAGES
+#define HEAP_EXPANSION_MAX_PAGES 64
+#endif
+
+/**
+ * Heap trimming policy:
+ *  Once the free segment at the end of the heap grows past
+ *  `HEAP_TRIM_THRESHOLD_PAGES`, the trailing pages are unmapped and handed
+ *  back to the physical memory manager. What stays mapped is the larger
+ *  of `HEAP_TRIM_RETAIN_PAGES` and the most recent expansion (capped at
+ *  `HEAP_EXPANSION_MAX_PAGES`), so a malloc/free pair that made the heap
+ *  grow can repeat without growing and shrinking it every time.
+ */
+#ifndef HEAP_TRIM_THRESHOLD_PAGES
+#define HEAP_TRIM_THRESHOLD_PAGES 16
+#endif
+
+#ifndef HEAP_TRIM_RETAIN_PAGES
+#define HEAP_TRIM_RETAIN_PAGES 4
+#endif
+
+static_assert(HEAP_TRIM_RETAIN_PAGES < HEAP_TRIM_THRESHOLD_PAGES,
+              "Heap trim threshold must be larger than the retained slack");
+
 struct HeapSegmentHeader {
     // Doubly linked list
     HeapSegmentHeader* last {nullptr};
@@ -15,6 +69,10 @@ struct HeapSegmentHeader {
     // Data fields
     uint64_t length {0};
     bool free {false};
+#ifdef HEAP_PROFILER
+    // Return address of whoever allocated this segment.
+    void* callsite {nullptr};
+#endif
 
     // Fragmentation prevention
     void combine_forward();
@@ -26,8 +84,15 @@ struct HeapSegmentHeader {
 
 void init_heap();
 
-// Enlarge the heap by a given number of bytes, aligned to next-highest page-aligned value
-void expand_heap(uint64_t numBytes);
+/**
+ * @brief Enlarge the heap so that it can fit an allocation of `numBytes`,
+ *      following the expansion policy above.
+ * @return the (free) last segment of the heap, at least `numBytes` long.
+ */
+HeapSegmentHeader* expand_heap(uint64_t numBytes);
+
+// Return trailing free pages to the physical memory manager (see trimming policy above).
+void heap_trim();
 
 __attribute__((malloc, alloc_size(1))) void* malloc(uint64_t numBytes);
 void free(void* address);
@@ -38,10 +103,35 @@ void operator delete(void* address) noexcept;
 void operator delete[](void* address) noexcept;
 
 void operator delete(void* address, uint64_t unused);
+
+// Placement new: construct an object in memory that has already been allocated.
+inline void* operator new(uint64_t, void* address) noexcept {
+    return address;
+}
+inline void* operator new[](uint64_t, void* address) noexcept {
+    return address;
+}
 void operator delete[](void* address, uint64_t unused);
 
 void heap_print_debug();
 void heap_print_debug_summed();
+void heap_print_debug_large();
+
+/**
+ * @brief Time a burst of small allocations and frees and print the
+ *      cycle counts, as a quick way to measure allocator changes.
+ */
+void heap_benchmark();
+
+/**
+ * @brief Alternate allocating and freeing a block just under the large
+ *      allocation threshold, and print how many times the heap grew and
+ *      shrank meanwhile (ideally once and never).
+ */
+void heap_benchmark_trim();
+
+// `heapbench` (`heap_benchmark()`) and `heapbench trim` (`heap_benchmark_trim()`).
+extern const Command gHeapBenchmarkCommand;
 
 extern void* sHeapStart;
 extern void* sHeapEnd;
@@ -0,0 +1,39 @@
+#ifndef _HEAP_PROFILER_HPP
+#define _HEAP_PROFILER_HPP
+
+#include <cstdint>
+#include <kernel/commands.hpp>
+
+/**
+ * Heap profiler:
+ *  When the kernel is built with `HEAP_PROFILER`, every allocation is
+ *  attributed to the return address of its caller and tallied in a fixed
+ *  table of `HEAP_PROFILER_CALLSITES` entries (allocation count, bytes,
+ *  live bytes, peak live bytes and cycles spent in `malloc`). Callsites
+ *  that don't fit in the table are only counted in aggregate.
+ *  Without `HEAP_PROFILER`, none of this is compiled into the allocator.
+ */
+#ifndef HEAP_PROFILER_CALLSITES
+#define HEAP_PROFILER_CALLSITES 256
+#endif
+
+static_assert((HEAP_PROFILER_CALLSITES & (HEAP_PROFILER_CALLSITES - 1)) == 0,
+              "Heap profiler callsite table size must be a power of two");
+
+void heap_profiler_record_allocation(void* callsite, uint64_t numBytes,
+                                     uint64_t cycles);
+void heap_profiler_record_free(void* callsite, uint64_t numBytes);
+
+// Forget all recorded statistics.
+void heap_profiler_reset();
+
+/**
+ * @brief Print the `count` callsites currently holding the most live heap
+ *      memory. Resolve the addresses with `addr2line -e kernel.elf`.
+ */
+void heap_profiler_dump(uint64_t count = 10);
+
+// `heapprof [count]` (dump) and `heapprof reset`.
+extern const Command gHeapProfilerCommand;
+
+#endif  // !_HEAP_PROFILER_HPP
@@ -2,11 +2,57 @@
 #define _MEMORY_HPP
 
 #include <int.hpp>
+#include <memory/common.hpp>
 
+struct Command;
+
+// Sizes from which the SIMD and non-temporal (cache-bypassing) routines are used.
+#ifndef MEMORY_SIMD_THRESHOLD
+#define MEMORY_SIMD_THRESHOLD 256
+#endif
+#ifndef MEMORY_NONTEMPORAL_THRESHOLD
+#define MEMORY_NONTEMPORAL_THRESHOLD MiB(1)
+#endif
+
+/**
+ * @note From `MEMORY_SIMD_THRESHOLD` bytes up, these routines use vector
+ *      registers. Interrupt handlers calling them must do so inside a
+ *      `kernel_fpu_begin()`/`kernel_fpu_end()` section.
+ */
+
+/**
+ * @return zero if the first `numBytes` bytes at `aptr` and `bptr` are
+ *      equal; otherwise the difference of the first pair of differing
+ *      bytes (negative if `aptr`'s byte is smaller).
+ */
 int memcmp(void* aptr, void* bptr, uint64_t numBytes);
+
+/**
+ * @brief Copy `numBytes` bytes from `src` to `dest`.
+ * @note The ranges must not overlap; use `memmove` if they might.
+ */
 void memcpy(const void* src, void* dest, uint64_t numBytes);
+
+// Copy `numBytes` bytes from `src` to `dest`; the ranges may overlap.
+void memmove(const void* src, void* dest, uint64_t numBytes);
+
 void memset(void* start, uint8_t value, uint64_t numBytes);
 
+/**
+ * @brief Bind the memory routines to the fastest variants the CPU
+ *      supports. Call once after `FPU::initialize()`.
+ */
+void memory_select_routines();
+
+/**
+ * @brief Time every variant of the memory routines over a range of
+ *      sizes and print the results.
+ */
+void memory_benchmark();
+
+// `membench`: run `memory_benchmark()`.
+extern const Command gMemoryBenchmarkCommand;
+
 // void volatile_read(const volatile void* ptr, volatile void* out, uint64_t length);
 // void volatile_write(void* data, volatile void* ptr, uint64_t length);
 
@@ -26,7 +26,8 @@ void* request_page();
 /**
  * @return the physical address of a contiguous region of physical
  *      memory that is guaranteed to have the next `numberOfPages`
- *      pages free, while locking all of them before returning.
+ *      pages free, while locking all of them before returning, or
+ *      `nullptr` if there is no such run (which callers fall back from).
  */
 void* request_pages(uint64_t numberOfPages);
 
@@ -13,36 +13,59 @@ namespace Memory {
 void init_virtual(PageTable*);
 void init_virtual();
 
-enum class ShowDebug {
-    Yes = 0,
-    No = 1,
-};
-
 /**
  * @brief Map a virtual address to a physical address in the
  *      given page map level four.
  */
 void map(PageTable*, void* virtualAddress, void* physicalAddress,
-         uint64_t mappingFlags, ShowDebug d = ShowDebug::No);
+         uint64_t mappingFlags);
 
 /**
  * @brief Map a virtual address to a physical address in the
  *      currently active page map level four.
  */
-void map(void* virtualAddress, void* physicalAddress, uint64_t mappingFlags,
-         ShowDebug d = ShowDebug::No);
+void map(void* virtualAddress, void* physicalAddress, uint64_t mappingFlags);
+
+/**
+ * @brief Map `numPages` contiguous virtual pages to contiguous physical
+ *      pages in the given page map level four. Intermediate tables are
+ *      only walked once per page table covered, not once per page.
+ */
+void map_pages(PageTable*, void* virtualAddress, void* physicalAddress,
+               uint64_t numPages, uint64_t mappingFlags);
+
+/**
+ * @brief Map `numPages` contiguous virtual pages to contiguous physical
+ *      pages in the currently active page map level four.
+ */
+void map_pages(void* virtualAddress, void* physicalAddress, uint64_t numPages,
+               uint64_t mappingFlags);
 
 /**
  * @brief If a mapping is marked as present within the given page
  *      map level four, it will be marked as not present.
  */
-void unmap(PageTable*, void* virtualAddress, ShowDebug d = ShowDebug::No);
+void unmap(PageTable*, void* virtualAddress);
 
 /**
  * @brief If a mapping is marked as present within the given page
  *      map level four, it will be marked as not present.
  */
-void unmap(void* virtualAddress, ShowDebug d = ShowDebug::No);
+void unmap(void* virtualAddress);
+
+/**
+ * @return the physical address that the given virtual address is mapped
+ *      to within the given page map level four, or `nullptr` if the
+ *      virtual address is not mapped.
+ */
+void* virtual_to_physical(PageTable*, void* virtualAddress);
+
+/**
+ * @return the physical address that the given virtual address is mapped
+ *      to within the currently active page map level four, or `nullptr`
+ *      if the virtual address is not mapped.
+ */
+void* virtual_to_physical(void* virtualAddress);
 
 /**
  * @brief Load the given address into control register three to update
@@ -0,0 +1,210 @@
+#ifndef _OBJECT_POOL_HPP
+#define _OBJECT_POOL_HPP
+
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory/allocator.hpp>
+#include <memory/common.hpp>
+#include <memory/heap.hpp>
+#include <memory/physical_memory_manager.hpp>
+#include <utility.hpp>
+
+// Number of free objects each processor may hold on to (see `PerCPUCache`).
+#ifndef OBJECT_POOL_CPU_CACHE_SIZE
+#define OBJECT_POOL_CPU_CACHE_SIZE 16
+#endif
+
+/**
+ * @brief A pool of fixed-size slots for objects of type `T`.
+ *
+ *  Slots are carved out of whole pages requested from the physical
+ *  memory manager (one page, or "slab", at a time) and free slots are
+ *  chained through their own storage, so allocation and deallocation
+ *  are O(1) with no per-object header. Slabs are only handed back when
+ *  the pool is destroyed.
+ *
+ *  With `PerCPUCache`, each processor keeps a small stack of free slots
+ *  of its own, and only touches the shared free list to refill or
+ *  flush half of it at a time.
+ */
+template <typename T, bool PerCPUCache = false> class ObjectPool {
+    union Slot {
+        Slot* Next;
+        alignas(T) uint8_t Storage[sizeof(T)];
+    };
+
+    struct Slab {
+        Slab* Next;
+    };
+
+    static constexpr uint64_t FirstSlotOffset =
+        (sizeof(Slab) + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+    static constexpr uint64_t SlotsPerSlab =
+        (PAGE_SIZE - FirstSlotOffset) / sizeof(Slot);
+
+    static_assert(SlotsPerSlab > 0, "Object is too large for a pool slab");
+
+public:
+    ObjectPool() {
+        Hook.Allocate = pool_allocate;
+        Hook.Free = pool_free;
+        Hook.Context = this;
+    }
+
+    /**
+     * @note Objects still alive in the pool are not destructed.
+     */
+    ~ObjectPool() {
+        Slab* it = Slabs;
+        while (it) {
+            Slab* next = it->Next;
+            Memory::free_page(it);
+            it = next;
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Allocate a slot and construct a `T` in it.
+    template <typename... Args> T* create(Args&&... args) {
+        void* memory = allocate();
+        if (memory == nullptr)
+            return nullptr;
+
+        return new (memory) T(forward<Args>(args)...);
+    }
+
+    // Destruct `object` and return its slot to the pool.
+    void destroy(T* object) {
+        if (object == nullptr)
+            return;
+
+        object->~T();
+        deallocate(object);
+    }
+
+    // @return an uninitialized slot large enough for a `T`, or `nullptr`.
+    void* allocate() {
+        if (PerCPUCache) {
+            CPUCache& cache = Caches[CPU::current_index()];
+            if (cache.Count == 0)
+                refill(cache);
+            if (cache.Count == 0)
+                return nullptr;
+
+            Live++;
+            return cache.Slots[--cache.Count];
+        }
+
+        if (FreeList == nullptr)
+            grow();
+        if (FreeList == nullptr)
+            return nullptr;
+
+        Slot* slot = FreeList;
+        FreeList = slot->Next;
+        Live++;
+        return slot;
+    }
+
+    // Return a slot handed out by `allocate()` without destructing it.
+    void deallocate(void* address) {
+        if (address == nullptr)
+            return;
+
+        Live--;
+        if (PerCPUCache) {
+            CPUCache& cache = Caches[CPU::current_index()];
+            if (cache.Count == OBJECT_POOL_CPU_CACHE_SIZE)
+                flush(cache);
+
+            cache.Slots[cache.Count++] = (Slot*)address;
+            return;
+        }
+
+        Slot* slot = (Slot*)address;
+        slot->Next = FreeList;
+        FreeList = slot;
+    }
+
+    /**
+     * @return a hook that allocates from this pool, for containers whose
+     *      nodes are `T`s. Requests larger than a slot fail.
+     */
+    Allocator* allocator() { return &Hook; }
+
+    // Number of objects currently allocated from the pool.
+    uint64_t live() const { return Live; }
+
+    // Number of objects the pool can hold without growing.
+    uint64_t capacity() const { return SlabCount * SlotsPerSlab; }
+
+private:
+    struct CPUCache {
+        uint64_t Count{0};
+        Slot* Slots[OBJECT_POOL_CPU_CACHE_SIZE];
+    };
+
+    static void* pool_allocate(void* context, uint64_t numBytes) {
+        if (numBytes > sizeof(Slot))
+            return nullptr;
+
+        return ((ObjectPool*)context)->allocate();
+    }
+
+    static void pool_free(void* context, void* address) {
+        ((ObjectPool*)context)->deallocate(address);
+    }
+
+    // Carve a fresh page into slots and push them onto the free list.
+    void grow() {
+        auto* slab = (Slab*)Memory::request_page();
+        if (slab == nullptr)
+            return;
+
+        slab->Next = Slabs;
+        Slabs = slab;
+        SlabCount++;
+
+        // Push in reverse so slots are handed out in address order.
+        auto* slots = (Slot*)((uint64_t)slab + FirstSlotOffset);
+        for (uint64_t i = SlotsPerSlab; i > 0; --i) {
+            slots[i - 1].Next = FreeList;
+            FreeList = &slots[i - 1];
+        }
+    }
+
+    // Move half a cache worth of slots from the shared free list into `cache`.
+    void refill(CPUCache& cache) {
+        while (cache.Count < OBJECT_POOL_CPU_CACHE_SIZE / 2) {
+            if (FreeList == nullptr)
+                grow();
+            if (FreeList == nullptr)
+                return;
+
+            Slot* slot = FreeList;
+            FreeList = slot->Next;
+            cache.Slots[cache.Count++] = slot;
+        }
+    }
+
+    // Move half of `cache` back onto the shared free list.
+    void flush(CPUCache& cache) {
+        while (cache.Count > OBJECT_POOL_CPU_CACHE_SIZE / 2) {
+            Slot* slot = cache.Slots[--cache.Count];
+            slot->Next = FreeList;
+            FreeList = slot;
+        }
+    }
+
+    Slot* FreeList{nullptr};
+    Slab* Slabs{nullptr};
+    uint64_t SlabCount{0};
+    uint64_t Live{0};
+    CPUCache Caches[PerCPUCache ? CPU_MAX_COUNT : 1];
+    Allocator Hook;
+};
+
+#endif  // !_OBJECT_POOL_HPP
@@ -0,0 +1,69 @@
+#ifndef _PROFILE_HPP
+#define _PROFILE_HPP
+
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <kernel/commands.hpp>
+#include <ring_buffer.hpp>
+#include <trace/trace.hpp>
+
+// Samples each processor's profile buffer holds before dropping new ones (a power of two).
+#ifndef PROFILE_BUFFER_SLOTS
+#define PROFILE_BUFFER_SLOTS 512
+#endif
+
+// Samples taken per second while profiling.
+#ifndef PROFILE_FREQUENCY
+#define PROFILE_FREQUENCY 1000
+#endif
+
+// Most return addresses kept per sample, counting the interrupted instruction.
+#define PROFILE_STACK_DEPTH 15
+
+/**
+ * @brief Where the timer interrupted, then the return addresses found by
+ *      following saved frame pointers (innermost first).
+ */
+struct ProfileSample {
+    uint64_t Depth;
+    uint64_t Frames[PROFILE_STACK_DEPTH];
+};
+
+static_assert(sizeof(ProfileSample) == 128, "ProfileSample should fill two cache lines");
+
+// Samples taken on one processor, by its timer interrupt only (which can't nest).
+struct ProfileBuffer {
+    RingBuffer<ProfileSample, PROFILE_BUFFER_SLOTS> Samples;
+    // Samples lost to a full buffer since the last dump.
+    uint64_t Dropped{0};
+};
+
+extern ProfileBuffer gProfileBuffers[CPU_MAX_COUNT];
+extern bool gProfiling;
+
+namespace Profile {
+/**
+ * @brief Record a sample of the code the system timer interrupted, at
+ *      `ip` with frame pointer `framePointer`. Does nothing unless
+ *      profiling.
+ */
+void sample(uint64_t ip, uint64_t framePointer);
+
+// Program the PIT and unmask IRQ0, taking `PROFILE_FREQUENCY` samples a second.
+void start();
+
+// Mask IRQ0 again.
+void stop();
+
+/**
+ * @brief Move every sample taken so far out to `output` as text, one
+ *      sample per line; see scripts/profile.py.
+ */
+void dump(Trace::Output output);
+
+// `profile start`, `profile stop` and `profile dump [serial|debugcon]`.
+extern const Command gCommand;
+}  // namespace Profile
+
+#endif  // !_PROFILE_HPP
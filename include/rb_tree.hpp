@@ -0,0 +1,361 @@
+#ifndef _RB_TREE_HPP
+#define _RB_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility.hpp>
+
+// Links embedded in an object so that it can be put in an `RBTree`.
+struct RBNode {
+    RBNode* Parent{nullptr};
+    RBNode* Left{nullptr};
+    RBNode* Right{nullptr};
+    bool Red{false};
+};
+
+// Order elements with `operator<`.
+struct RBDefaultLess {
+    template <typename T> bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+// Keep no per-subtree data.
+struct RBNoAugment {
+    template <typename T> void operator()(T&, T*, T*) const {}
+};
+
+/**
+ * @brief A red-black tree of `T`s, threaded through their `Member` nodes.
+ *      The tree never owns, allocates or frees its elements. Insertion,
+ *      removal and lookup are O(log n).
+ *
+ *  `Less(a, b)` orders elements; equal elements are kept in insertion
+ *  order.
+ *
+ *  `Augment(node, left, right)` is called whenever the set of elements
+ *  below `node` may have changed (`left` and `right` being its children,
+ *  or `nullptr`), children before parents. It lets elements maintain data
+ *  about their whole subtree, like the largest end address in an
+ *  interval tree, which `root()`/`left()`/`right()` can then search.
+ *
+ * @note The tree must not be copied while it holds elements.
+ */
+template <typename T, RBNode T::*Member, typename Less = RBDefaultLess,
+          typename Augment = RBNoAugment>
+class RBTree {
+public:
+    RBTree() = default;
+
+    RBTree(const RBTree&) = delete;
+    RBTree& operator=(const RBTree&) = delete;
+
+    bool empty() const { return Root == nullptr; }
+    uint64_t length() const { return Count; }
+
+    T* root() { return owner(Root); }
+    static T* left(T& item) { return owner(node(item)->Left); }
+    static T* right(T& item) { return owner(node(item)->Right); }
+    static T* parent(T& item) { return owner(node(item)->Parent); }
+
+    void insert(T& item) {
+        RBNode* n = node(item);
+        RBNode* parent = nullptr;
+        RBNode** link = &Root;
+        while (*link) {
+            parent = *link;
+            link = Less()(item, *owner(parent)) ? &parent->Left : &parent->Right;
+        }
+
+        n->Parent = parent;
+        n->Left = nullptr;
+        n->Right = nullptr;
+        n->Red = true;
+        *link = n;
+        Count++;
+
+        propagate(n);
+        insert_fixup(n);
+    }
+
+    // Take `item`, which must be in this tree, out of it.
+    void remove(T& item) {
+        RBNode* z = node(item);
+        RBNode* x;
+        RBNode* xParent;
+        bool removedRed = z->Red;
+
+        if (z->Left == nullptr) {
+            x = z->Right;
+            xParent = z->Parent;
+            transplant(z, z->Right);
+        } else if (z->Right == nullptr) {
+            x = z->Left;
+            xParent = z->Parent;
+            transplant(z, z->Left);
+        } else {
+            // Replace `z` with its successor `y`, the leftmost node on its right.
+            RBNode* y = z->Right;
+            while (y->Left)
+                y = y->Left;
+
+            removedRed = y->Red;
+            x = y->Right;
+            if (y->Parent == z)
+                xParent = y;
+            else {
+                xParent = y->Parent;
+                transplant(y, y->Right);
+                y->Right = z->Right;
+                y->Right->Parent = y;
+            }
+            transplant(z, y);
+            y->Left = z->Left;
+            y->Left->Parent = y;
+            y->Red = z->Red;
+        }
+
+        z->Parent = nullptr;
+        z->Left = nullptr;
+        z->Right = nullptr;
+        Count--;
+
+        // Everything from the splice point up lost an element.
+        propagate(xParent);
+        if (!removedRed)
+            remove_fixup(x, xParent);
+    }
+
+    // @return the smallest element, or `nullptr`.
+    T* first() {
+        RBNode* n = Root;
+        while (n && n->Left)
+            n = n->Left;
+        return owner(n);
+    }
+
+    // @return the largest element, or `nullptr`.
+    T* last() {
+        RBNode* n = Root;
+        while (n && n->Right)
+            n = n->Right;
+        return owner(n);
+    }
+
+    // @return the element after `item` in order, or `nullptr`.
+    T* next(T& item) {
+        RBNode* n = node(item);
+        if (n->Right) {
+            n = n->Right;
+            while (n->Left)
+                n = n->Left;
+            return owner(n);
+        }
+        while (n->Parent && n == n->Parent->Right)
+            n = n->Parent;
+        return owner(n->Parent);
+    }
+
+    // @return the element before `item` in order, or `nullptr`.
+    T* prev(T& item) {
+        RBNode* n = node(item);
+        if (n->Left) {
+            n = n->Left;
+            while (n->Right)
+                n = n->Right;
+            return owner(n);
+        }
+        while (n->Parent && n == n->Parent->Left)
+            n = n->Parent;
+        return owner(n->Parent);
+    }
+
+    /**
+     * @brief Find an element by key. `compare(key, element)` returns a
+     *      negative number, zero or a positive number as `key` orders
+     *      before, equal to or after `element`.
+     */
+    template <typename Key, typename Compare> T* find(const Key& key, Compare compare) {
+        RBNode* n = Root;
+        while (n) {
+            int result = compare(key, *owner(n));
+            if (result == 0)
+                return owner(n);
+            n = result < 0 ? n->Left : n->Right;
+        }
+        return nullptr;
+    }
+
+    // @return the first element not ordered before `key` (see `find`), or `nullptr`.
+    template <typename Key, typename Compare> T* lower_bound(const Key& key, Compare compare) {
+        RBNode* n = Root;
+        RBNode* out = nullptr;
+        while (n) {
+            if (compare(key, *owner(n)) <= 0) {
+                out = n;
+                n = n->Left;
+            } else
+                n = n->Right;
+        }
+        return owner(out);
+    }
+
+private:
+    static RBNode* node(T& item) { return &(item.*Member); }
+    static T* owner(RBNode* n) { return n ? owner_of(n, Member) : nullptr; }
+    static bool is_red(RBNode* n) { return n && n->Red; }
+
+    static void augment(RBNode* n) { Augment()(*owner(n), owner(n->Left), owner(n->Right)); }
+
+    // Re-augment `n` and every node above it.
+    void propagate(RBNode* n) {
+        for (; n; n = n->Parent)
+            augment(n);
+    }
+
+    // Put `with` (possibly `nullptr`) where `n` hangs from its parent.
+    void transplant(RBNode* n, RBNode* with) {
+        if (n->Parent == nullptr)
+            Root = with;
+        else if (n == n->Parent->Left)
+            n->Parent->Left = with;
+        else
+            n->Parent->Right = with;
+
+        if (with)
+            with->Parent = n->Parent;
+    }
+
+    void rotate_left(RBNode* x) {
+        RBNode* y = x->Right;
+        x->Right = y->Left;
+        if (y->Left)
+            y->Left->Parent = x;
+        transplant(x, y);
+        y->Left = x;
+        x->Parent = y;
+
+        // The subtree as a whole holds the same elements, so only these two change.
+        augment(x);
+        augment(y);
+    }
+
+    void rotate_right(RBNode* x) {
+        RBNode* y = x->Left;
+        x->Left = y->Right;
+        if (y->Right)
+            y->Right->Parent = x;
+        transplant(x, y);
+        y->Right = x;
+        x->Parent = y;
+
+        augment(x);
+        augment(y);
+    }
+
+    void insert_fixup(RBNode* n) {
+        while (is_red(n->Parent)) {
+            RBNode* parent = n->Parent;
+            RBNode* grandparent = parent->Parent;
+
+            if (parent == grandparent->Left) {
+                RBNode* uncle = grandparent->Right;
+                if (is_red(uncle)) {
+                    parent->Red = false;
+                    uncle->Red = false;
+                    grandparent->Red = true;
+                    n = grandparent;
+                    continue;
+                }
+                if (n == parent->Right) {
+                    n = parent;
+                    rotate_left(n);
+                    parent = n->Parent;
+                }
+                parent->Red = false;
+                grandparent->Red = true;
+                rotate_right(grandparent);
+            } else {
+                RBNode* uncle = grandparent->Left;
+                if (is_red(uncle)) {
+                    parent->Red = false;
+                    uncle->Red = false;
+                    grandparent->Red = true;
+                    n = grandparent;
+                    continue;
+                }
+                if (n == parent->Left) {
+                    n = parent;
+                    rotate_right(n);
+                    parent = n->Parent;
+                }
+                parent->Red = false;
+                grandparent->Red = true;
+                rotate_left(grandparent);
+            }
+        }
+        Root->Red = false;
+    }
+
+    // `x` (possibly `nullptr`, hence `parent`) carries an extra black.
+    void remove_fixup(RBNode* x, RBNode* parent) {
+        while (x != Root && !is_red(x)) {
+            if (x == parent->Left) {
+                RBNode* sibling = parent->Right;
+                if (is_red(sibling)) {
+                    sibling->Red = false;
+                    parent->Red = true;
+                    rotate_left(parent);
+                    sibling = parent->Right;
+                }
+                if (!is_red(sibling->Left) && !is_red(sibling->Right)) {
+                    sibling->Red = true;
+                    x = parent;
+                    parent = x->Parent;
+                    continue;
+                }
+                if (!is_red(sibling->Right)) {
+                    sibling->Left->Red = false;
+                    sibling->Red = true;
+                    rotate_right(sibling);
+                    sibling = parent->Right;
+                }
+                sibling->Red = parent->Red;
+                parent->Red = false;
+                sibling->Right->Red = false;
+                rotate_left(parent);
+                x = Root;
+            } else {
+                RBNode* sibling = parent->Left;
+                if (is_red(sibling)) {
+                    sibling->Red = false;
+                    parent->Red = true;
+                    rotate_right(parent);
+                    sibling = parent->Left;
+                }
+                if (!is_red(sibling->Left) && !is_red(sibling->Right)) {
+                    sibling->Red = true;
+                    x = parent;
+                    parent = x->Parent;
+                    continue;
+                }
+                if (!is_red(sibling->Left)) {
+                    sibling->Right->Red = false;
+                    sibling->Red = true;
+                    rotate_left(sibling);
+                    sibling = parent->Left;
+                }
+                sibling->Red = parent->Red;
+                parent->Red = false;
+                sibling->Left->Red = false;
+                rotate_right(parent);
+                x = Root;
+            }
+        }
+        if (x)
+            x->Red = false;
+    }
+
+    RBNode* Root{nullptr};
+    uint64_t Count{0};
+};
+
+#endif  // !_RB_TREE_HPP
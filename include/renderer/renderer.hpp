@@ -5,6 +5,7 @@
 #include <int.hpp>
 #include <math.hpp>
 #include <memory/memory.hpp>
+#include <string_view.hpp>
 
 struct PSF1_HEADER {
     // Magic bytes to indicate PSF1 font type
@@ -52,9 +53,7 @@ class Renderer {
     void clamp_draw_position(Vector2<uint64_t>& position);
 
     // Update memory contents of render from target
-    void swap() {
-        memcpy(Target->BaseAddress, Render->BaseAddress, Target->BufferSize);
-    }
+    void swap();
 
     // Update size of memory contents of render from target at position
     void swap(Vector2<uint64_t> position, Vector2<uint64_t> size);
@@ -123,8 +122,8 @@ class Renderer {
     void putChar(Vector2<uint64_t>& position, char c,
                  uint32_t color = 0xffffffff);
 
-    // put a null-terminated string of characters to the screen, wrapping if necessary
-    void puts(Vector2<uint64_t>& position, const char* str,
+    // put a string of characters to the screen, wrapping if necessary
+    void puts(Vector2<uint64_t>& position, StringView str,
               uint32_t color = 0xffffffff);
 };
 
@@ -0,0 +1,169 @@
+#ifndef _RING_BUFFER_HPP
+#define _RING_BUFFER_HPP
+
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A bounded, lock-free queue of `SlotCount` (a power of two) `T`s
+ *      for handing data from interrupt handlers (or other processors) to
+ *      a single consumer, without allocating.
+ *
+ *  With `MultiProducer` false, exactly one context may push at a time.
+ *  With it true, any number may: producers claim slots by advancing the
+ *  tail with compare-and-swap, and publish each slot with a per-slot
+ *  sequence number so that the consumer never reads a slot that is
+ *  claimed but not yet written. Either way, only one context may pop.
+ *
+ *  The producer and consumer indices live on separate cache lines, and
+ *  each side caches the other's index, so the two only share a line when
+ *  the queue looks full (or empty).
+ *
+ *  `T` is copied in and out by assignment, so it should be small and
+ *  trivially copyable.
+ */
+template <typename T, uint64_t SlotCount, bool MultiProducer = false> class RingBuffer {
+    static_assert(SlotCount && (SlotCount & (SlotCount - 1)) == 0,
+                  "RingBuffer slot count must be a power of two");
+
+    static constexpr uint64_t Mask = SlotCount - 1;
+
+public:
+    constexpr RingBuffer() = default;
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    static constexpr uint64_t capacity() { return SlotCount; }
+
+    // @return the number of queued items; only exact when nobody is pushing or popping.
+    uint64_t length() const {
+        return __atomic_load_n(&Tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+    }
+
+    bool empty() const { return length() == 0; }
+
+    // @return false if the queue is full.
+    bool push(const T& item) { return push(&item, 1) == 1; }
+
+    // @return false if the queue is empty.
+    bool pop(T& item) { return pop(&item, 1) == 1; }
+
+    /**
+     * @brief Queue up to `count` items from `items`, in order.
+     * @return how many were queued; fewer than `count` if the queue filled up.
+     */
+    uint64_t push(const T* items, uint64_t count) {
+        uint64_t tail;
+        uint64_t claimed;
+
+        if (MultiProducer) {
+            tail = __atomic_load_n(&Tail, __ATOMIC_RELAXED);
+            do {
+                claimed = claimable(tail, count);
+                if (claimed == 0) return 0;
+            } while (!__atomic_compare_exchange_n(&Tail, &tail, tail + claimed, true,
+                                                  __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+            for (uint64_t i = 0; i < claimed; ++i) {
+                Slots[(tail + i) & Mask] = items[i];
+                // Publish this slot to the consumer.
+                __atomic_store_n(&Sequences[(tail + i) & Mask], tail + i + 1, __ATOMIC_RELEASE);
+            }
+            return claimed;
+        }
+
+        tail = __atomic_load_n(&Tail, __ATOMIC_RELAXED);
+        claimed = claimable(tail, count);
+        for (uint64_t i = 0; i < claimed; ++i)
+            Slots[(tail + i) & Mask] = items[i];
+
+        // Publish every slot at once.
+        __atomic_store_n(&Tail, tail + claimed, __ATOMIC_RELEASE);
+        return claimed;
+    }
+
+    /**
+     * @brief Dequeue up to `count` items into `items`, in order.
+     * @return how many were dequeued.
+     */
+    uint64_t pop(T* items, uint64_t count) {
+        uint64_t head = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+        uint64_t popped = 0;
+
+        if (MultiProducer) {
+            // Stop at the first slot that hasn't been published yet.
+            while (popped < count) {
+                uint64_t index = (head + popped) & Mask;
+                if (__atomic_load_n(&Sequences[index], __ATOMIC_ACQUIRE) != head + popped + 1)
+                    break;
+
+                items[popped++] = Slots[index];
+            }
+        } else {
+            uint64_t available = CachedTail - head;
+            if (available < count) {
+                CachedTail = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+                available = CachedTail - head;
+            }
+
+            popped = available < count ? available : count;
+            for (uint64_t i = 0; i < popped; ++i)
+                items[i] = Slots[(head + i) & Mask];
+        }
+
+        // Hand the slots back to the producers.
+        if (popped)
+            __atomic_store_n(&Head, head + popped, __ATOMIC_RELEASE);
+        return popped;
+    }
+
+private:
+    // @return how many of `count` slots from `tail` are free (at most).
+    uint64_t claimable(uint64_t tail, uint64_t count) {
+        // Acquire/release so that a head cached by another producer still
+        // orders our writes after the consumer's reads of those slots.
+        int64_t used = (int64_t)(tail - __atomic_load_n(&CachedHead, __ATOMIC_ACQUIRE));
+        if (used < 0 || (uint64_t)used + count > SlotCount) {
+            uint64_t head = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+            __atomic_store_n(&CachedHead, head, __ATOMIC_RELEASE);
+            used = (int64_t)(tail - head);
+        }
+
+        // With several producers, `tail` may be stale (the CAS then fails and
+        // retries) and the cached head may lag behind, or even run ahead of it.
+        if (used < 0)
+            used = 0;
+        if ((uint64_t)used >= SlotCount)
+            return 0;
+
+        uint64_t space = SlotCount - used;
+        return space < count ? space : count;
+    }
+
+    // Consumer side.
+    alignas(CACHE_LINE_SIZE) uint64_t Head{0};
+    uint64_t CachedTail{0};
+
+    // Producer side.
+    alignas(CACHE_LINE_SIZE) uint64_t Tail{0};
+    uint64_t CachedHead{0};
+
+    alignas(CACHE_LINE_SIZE) T Slots[SlotCount]{};
+    // Index (plus one) last published in each slot; multi-producer only.
+    uint64_t Sequences[MultiProducer ? SlotCount : 1]{};
+};
+
+/**
+ * @brief Whether a `T` can be built at compile time. A global that can
+ *      lands in .bss; one that can't needs a constructor, and this kernel
+ *      never runs them.
+ */
+template <typename T> constexpr bool constant_initializable() {
+    T value;
+    (void)value;
+    return true;
+}
+
+#endif  // !_RING_BUFFER_HPP
@@ -0,0 +1,64 @@
+#ifndef _STATIC_KEY_HPP
+#define _STATIC_KEY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A flag that code tests by executing a 5-byte `nop` where the
+ *      branch would be. `static_key_set()` rewrites every such `nop` into
+ *      a `jmp` to the guarded code (and back), so a disabled test costs
+ *      no load, compare or branch slot.
+ *
+ *  Every test site records `{site, target, key}` in the `.static_keys`
+ *  section, which the linker script gathers between `STATIC_KEYS_START`
+ *  and `STATIC_KEYS_END`.
+ */
+struct StaticKey {
+    bool Enabled;
+};
+
+struct StaticKeyEntry {
+    uint64_t Site;
+    uint64_t Target;
+    StaticKey* Key;
+};
+
+extern StaticKeyEntry STATIC_KEYS_START[];
+extern StaticKeyEntry STATIC_KEYS_END[];
+
+/**
+ * @brief Evaluates to whether `key` (an object with a fixed address) is
+ *      enabled, by falling through a `nop` (false) or taking the `jmp`
+ *      patched over it (true).
+ */
+#define STATIC_KEY_ENABLED(key)                                                        \
+    ({                                                                                 \
+        __label__ static_key_on_;                                                      \
+        bool enabled_ = false;                                                         \
+        asm goto("1: .byte 0x0f, 0x1f, 0x44, 0x00, 0x00\n"                             \
+                 ".pushsection .static_keys, \"aw\"\n"                                 \
+                 ".balign 8\n"                                                         \
+                 ".quad 1b, %l[static_key_on_], %c0\n"                                 \
+                 ".popsection\n"                                                       \
+                 :                                                                     \
+                 : "i"(&(key))                                                         \
+                 :                                                                     \
+                 : static_key_on_);                                                    \
+        if (false) {                                                                   \
+        static_key_on_:                                                                \
+            enabled_ = true;                                                           \
+        }                                                                              \
+        enabled_;                                                                      \
+    })
+
+/**
+ * @brief Turn `key` on or off, patching every site that tests it. Runs
+ *      with interrupts disabled, as a site may be executing meanwhile.
+ *
+ * @note Kernel text must be mapped writable (it is, by `init_virtual()`).
+ *      Only one processor runs for now, so no cross-modification sync.
+ */
+void static_key_set(StaticKey& key, bool enabled);
+
+#endif  // !_STATIC_KEY_HPP
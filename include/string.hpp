@@ -4,45 +4,80 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstr.hpp>
+#include <memory/allocator.hpp>
 #include <memory/heap.hpp>
 #include <memory/memory.hpp>
-
-constexpr uint64_t STRING_INITIAL_LENGTH = 10;
-
+#include <string_view.hpp>
+
+// Strings up to this many bytes are stored inside the `String` itself.
+#ifndef STRING_INLINE_CAPACITY
+#define STRING_INLINE_CAPACITY 23
+#endif
+
+/**
+ * @brief A NUL-terminated, length-tracked byte string.
+ *
+ *  Contents of up to `STRING_INLINE_CAPACITY` bytes live in an inline
+ *  buffer, so short strings never allocate. Longer contents are moved to
+ *  a buffer from `Alloc`, which is kept (see `capacity()`) when the string
+ *  shrinks or is reassigned, and grows geometrically when appended to.
+ *
+ *  To assemble a string out of many pieces, use a `StringBuilder`.
+ */
 class String {
 public:
-    // Default constructor
-    String() : Length(STRING_INITIAL_LENGTH) {
-        Buffer = new uint8_t[Length + 1];
-        memset(Buffer, 0, Length);
-    }
+    String() { Inline[0] = '\0'; }
+
+    // Allocate from `allocator` instead of the heap (see `Allocator`).
+    explicit String(Allocator* allocator) : Alloc(allocator) { Inline[0] = '\0'; }
 
     // Copy constructor
-    String(const String& original) {
-        Length = original.length();
-        Buffer = new uint8_t[Length + 1];
-        Buffer[Length] = '\0';
-        memcpy(original.bytes(), Buffer, Length);
+    String(const String& original, Allocator* allocator = nullptr)
+        : Alloc(allocator) {
+        Inline[0] = '\0';
+        assign(original.Buffer, original.Length);
     }
 
-    String(const char* cstr) {
-        Length = strlen(cstr) - 1;
-        Buffer = new uint8_t[Length + 1];
-        memcpy((void*)cstr, Buffer, Length + 1);
+    // Move constructor; the buffer (and the allocator that owns it) is taken over.
+    String(String&& other) noexcept : Alloc(other.Alloc) { take(other); }
+
+    String(const char* cstr, Allocator* allocator = nullptr) : Alloc(allocator) {
+        // Short strings are measured and copied in the same pass.
+        uint64_t i = 0;
+        for (; i <= STRING_INLINE_CAPACITY; ++i) {
+            Inline[i] = cstr[i];
+            if (cstr[i] == '\0') {
+                Length = i;
+                return;
+            }
+        }
+
+        Inline[0] = '\0';
+        assign(cstr, i + strlen(&cstr[i]) - 1);
     }
 
-    String(const char* cstr, uint64_t byteCount) {
-        Length = byteCount;
-        Buffer = new uint8_t[Length + 1];
-        memcpy((void*)cstr, Buffer, Length);
-        Buffer[Length] = '\0';
+    String(const char* cstr, uint64_t byteCount, Allocator* allocator = nullptr)
+        : Alloc(allocator) {
+        Inline[0] = '\0';
+        assign(cstr, byteCount);
     }
 
-    ~String() { delete[] Buffer; }
+    String(StringView view, Allocator* allocator = nullptr) : Alloc(allocator) {
+        Inline[0] = '\0';
+        assign(view.data(), view.length());
+    }
+
+    ~String() { release(); }
 
     uint64_t length() { return Length; }
     uint64_t length() const { return Length; }
 
+    // Number of bytes the string can hold without allocating.
+    uint64_t capacity() const { return Capacity; }
+
+    // Make room for at least `capacity` bytes, so appending up to it won't allocate.
+    void reserve(uint64_t capacity) { reserve_exact(capacity); }
+
     uint8_t* bytes() const { return Buffer; }
 
     enum class Side {
@@ -54,27 +89,23 @@ public:
      * @note Character at index is included in right side.
      */
     String& chop(uint64_t index, Side side) {
-        if (index > length() - 1) return *this;
+        if (index >= Length) return *this;
 
-        if (side == String::Side::Left) {
+        if (side == String::Side::Left)
             Length = index;
-            uint8_t* oldBuffer = Buffer;
-            Buffer = new uint8_t[Length + 1];
-            memcpy((void*)oldBuffer, Buffer, Length);
-            Buffer[Length] = '\0';
-            delete[] oldBuffer;
-        } else {
-            Length = strlen(&data()[index]) - 1;
-            uint8_t* oldBuffer = Buffer;
-            Buffer = new uint8_t[Length + 1];
-            memcpy((void*)&oldBuffer[index], Buffer, Length + 1);
-            delete[] oldBuffer;
+        else {
+            Length -= index;
+            memmove(&Buffer[index], Buffer, Length);
         }
+        Buffer[Length] = '\0';
         return *this;
     }
 
     const char* data() const { return (const char*)Buffer; }
 
+    StringView view() const { return StringView(data(), Length); }
+    operator StringView() const { return view(); }
+
     /**
      * @brief Make a copy of the current contents of the string on the heap
      *
@@ -92,14 +123,7 @@ public:
     String& operator=(const String& other) {
         if (this == &other) return *this;
 
-        Length = other.Length;
-
-        delete[] Buffer;
-
-        Buffer = new uint8_t[Length + 1];
-        Buffer[Length] = '\0';
-        memcpy(other.Buffer, Buffer, Length);
-
+        assign(other.Buffer, other.Length);
         return *this;
     }
 
@@ -107,13 +131,10 @@ public:
     String& operator=(String&& other) noexcept {
         if (this == &other) return *this;
 
-        delete[] Buffer;
-
-        // FIXME: Need atomic exchange here for Buffer pointer swap...
-        Buffer = other.Buffer;
-        other.Buffer = nullptr;
-        Length = other.Length;
-        other.Length = 0;
+        release();
+        // The buffer must be freed by whoever allocated it.
+        Alloc = other.Alloc;
+        take(other);
 
         return *this;
     }
@@ -121,40 +142,19 @@ public:
     String& operator+(const String& other) {
         if (this == &other) return *this;
 
-        uint64_t oldLength = Length;
-        Length += other.Length;
-        uint8_t* newBuffer = new uint8_t[Length + 1];
-
-        memcpy(&Buffer[0], &newBuffer[0], oldLength);
-        memcpy(&other.Buffer[0], &newBuffer[oldLength], other.Length);
-
-        uint8_t* oldBuffer = Buffer;
-        Buffer = newBuffer;
-        delete[] oldBuffer;
-
+        append(other.Buffer, other.Length);
         return *this;
     }
 
     String& operator+(const char* cstr) {
         if (cstr == nullptr) return *this;
 
-        uint64_t stringLength = strlen(cstr);
-
-        if (stringLength <= 1) return *this;
-
-        uint64_t oldLength = Length;
-        Length += stringLength - 1;
-        uint8_t* newBuffer = new uint8_t[Length + 1];
-
-        memcpy(&Buffer[0], &newBuffer[0], oldLength);
-        memcpy((void*)cstr, &newBuffer[oldLength], stringLength - 1);
-
-        newBuffer[Length] = '\0';
-        uint8_t* oldBuffer = Buffer;
-        Buffer = newBuffer;
-
-        delete[] oldBuffer;
+        append(cstr, strlen(cstr) - 1);
+        return *this;
+    }
 
+    String& operator+(StringView view) {
+        append(view.data(), view.length());
         return *this;
     }
 
@@ -168,21 +168,116 @@ public:
         return *this;
     }
 
+    String& operator+=(StringView view) {
+        this->operator+(view);
+        return *this;
+    }
+
+    // Out of range indices give the NUL terminator.
     uint8_t& operator[](uint64_t index) const {
-        if (index >= Length) return Buffer[Length - 1];
+        if (index >= Length) return Buffer[Length];
 
         return Buffer[index];
     }
 
     uint8_t& operator[](uint64_t index) {
-        if (index >= Length) return Buffer[Length - 1];
+        if (index >= Length) return Buffer[Length];
 
         return Buffer[index];
     }
 
+    Allocator* allocator() const { return Alloc; }
+
 private:
-    uint8_t* Buffer{nullptr};
+    friend class StringBuilder;
+
+    // Adopt `buffer`, allocated from `allocator` and holding `capacity` bytes plus NUL.
+    String(uint8_t* buffer, uint64_t length, uint64_t capacity, Allocator* allocator)
+        : Buffer(buffer), Length(length), Capacity(capacity), Alloc(allocator) {
+        Inline[0] = '\0';
+    }
+
+    bool is_inline() const { return Buffer == Inline; }
+
+    uint8_t* allocate_buffer(uint64_t numBytes) {
+        return (uint8_t*)allocate(Alloc, numBytes);
+    }
+
+    void free_buffer(uint8_t* buffer) {
+        if (buffer)
+            deallocate(Alloc, buffer);
+    }
+
+    // Free an allocated buffer and go back to being empty and inline.
+    void release() {
+        if (!is_inline())
+            free_buffer(Buffer);
+
+        Buffer = Inline;
+        Capacity = STRING_INLINE_CAPACITY;
+        Length = 0;
+        Inline[0] = '\0';
+    }
+
+    // Steal `other`'s contents, leaving it empty. `Alloc` must already match.
+    void take(String& other) {
+        if (other.is_inline()) {
+            memcpy(other.Inline, Inline, other.Length + 1);
+            Buffer = Inline;
+        } else
+            Buffer = other.Buffer;
+        Capacity = other.Capacity;
+        Length = other.Length;
+
+        other.Buffer = other.Inline;
+        other.Capacity = STRING_INLINE_CAPACITY;
+        other.Length = 0;
+        other.Inline[0] = '\0';
+    }
+
+    /**
+     * @brief Make room for `capacity` bytes (plus NUL), keeping the contents.
+     * @return false if the buffer could not be allocated.
+     */
+    bool reserve_exact(uint64_t capacity) {
+        if (capacity <= Capacity) return true;
+
+        uint8_t* newBuffer = allocate_buffer(capacity + 1);
+        if (newBuffer == nullptr) return false;
+
+        memcpy(Buffer, newBuffer, Length + 1);
+        if (!is_inline())
+            free_buffer(Buffer);
+
+        Buffer = newBuffer;
+        Capacity = capacity;
+        return true;
+    }
+
+    void assign(const void* source, uint64_t numBytes) {
+        Length = 0;
+        Buffer[0] = '\0';
+        append(source, numBytes);
+    }
+
+    void append(const void* source, uint64_t numBytes) {
+        // Grow geometrically so repeated appends copy O(n) bytes in total.
+        uint64_t needed = Length + numBytes;
+        if (needed > Capacity && !reserve_exact(needed > Capacity * 2 ? needed : Capacity * 2))
+            return;
+
+        memcpy(source, &Buffer[Length], numBytes);
+        Length += numBytes;
+        Buffer[Length] = '\0';
+    }
+
+    uint8_t* Buffer{Inline};
     uint64_t Length{0};
+    // Bytes `Buffer` can hold, not counting the NUL terminator.
+    uint64_t Capacity{STRING_INLINE_CAPACITY};
+    // `nullptr` means the heap.
+    Allocator* Alloc{nullptr};
+    uint8_t Inline[STRING_INLINE_CAPACITY + 1];
 };
 
 inline String& operator<<(String& lhs, const String& rhs) {
@@ -198,4 +293,4 @@ inline bool operator==(const String& lhs, const String& rhs) {
 
 inline bool operator!=(const String& lhs, const String& rhs) { return !(lhs == rhs); }
 
-#endif  // !_STRING_HPP
\ No newline at end of file
+#endif  // !_STRING_HPP
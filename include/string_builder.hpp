@@ -0,0 +1,163 @@
+#ifndef _STRING_BUILDER_HPP
+#define _STRING_BUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstr.hpp>
+#include <memory/allocator.hpp>
+#include <memory/memory.hpp>
+#include <string.hpp>
+#include <string_view.hpp>
+
+// Capacity of a builder's first buffer.
+#ifndef STRING_BUILDER_INITIAL_CAPACITY
+#define STRING_BUILDER_INITIAL_CAPACITY 32
+#endif
+
+/**
+ * @brief Assembles a `String` out of many pieces.
+ *
+ *  The buffer at least doubles whenever it runs out of room, so appending
+ *  is amortised O(1) and building an N-byte string copies O(N) bytes.
+ *  `build()` hands the buffer over to the resulting `String` without
+ *  copying it.
+ */
+class StringBuilder {
+public:
+    explicit StringBuilder(Allocator* allocator = nullptr) : Alloc(allocator) {}
+
+    explicit StringBuilder(uint64_t capacity, Allocator* allocator = nullptr)
+        : Alloc(allocator) {
+        reserve(capacity);
+    }
+
+    ~StringBuilder() {
+        if (Buffer)
+            deallocate(Alloc, Buffer);
+    }
+
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    uint64_t length() const { return Length; }
+    uint64_t capacity() const { return Capacity; }
+
+    // @return the contents so far (NUL-terminated), valid until the next append.
+    const char* data() const { return Buffer ? (const char*)Buffer : ""; }
+
+    // Forget the contents, keeping the buffer.
+    void clear() {
+        Length = 0;
+        if (Buffer)
+            Buffer[0] = '\0';
+    }
+
+    /**
+     * @brief Make room for at least `capacity` bytes (plus NUL).
+     * @return false if the buffer could not be allocated.
+     */
+    bool reserve(uint64_t capacity) {
+        if (capacity <= Capacity) return true;
+
+        auto* newBuffer = (uint8_t*)allocate(Alloc, capacity + 1);
+        if (newBuffer == nullptr) return false;
+
+        if (Buffer) {
+            memcpy(Buffer, newBuffer, Length + 1);
+            deallocate(Alloc, Buffer);
+        } else
+            newBuffer[0] = '\0';
+
+        Buffer = newBuffer;
+        Capacity = capacity;
+        return true;
+    }
+
+    StringBuilder& append(char character) {
+        if (grow(1)) {
+            Buffer[Length++] = (uint8_t)character;
+            Buffer[Length] = '\0';
+        }
+        return *this;
+    }
+
+    StringBuilder& append(const char* cstr, uint64_t numBytes) {
+        if (grow(numBytes)) {
+            memcpy(cstr, &Buffer[Length], numBytes);
+            Length += numBytes;
+            Buffer[Length] = '\0';
+        }
+        return *this;
+    }
+
+    StringBuilder& append(const char* cstr) {
+        if (cstr == nullptr) return *this;
+
+        return append(cstr, strlen(cstr) - 1);
+    }
+
+    StringBuilder& append(const String& string) {
+        return append(string.data(), string.length());
+    }
+
+    StringBuilder& append(StringView view) { return append(view.data(), view.length()); }
+
+    StringBuilder& append(bool value) { return append(to_string(value)); }
+
+    StringBuilder& append(uint64_t value) {
+        char digits[TO_STRING_BUF_SZ];
+        return append(digits, to_string(value, digits));
+    }
+
+    StringBuilder& append(int64_t value) {
+        char digits[TO_STRING_BUF_SZ];
+        return append(digits, to_string(value, digits));
+    }
+
+    StringBuilder& append(uint32_t value) { return append((uint64_t)value); }
+    StringBuilder& append(int32_t value) { return append((int64_t)value); }
+
+    // Append all 16 hexadecimal digits of `value`, like `to_hexstring`.
+    StringBuilder& append_hex(uint64_t value, bool capital = false) {
+        // Formatted in place; the buffer always has room for the NUL.
+        if (grow(16))
+            Length += to_hexstring(value, (char*)Buffer + Length, capital);
+        return *this;
+    }
+
+    template <typename T> StringBuilder& operator<<(const T& value) { return append(value); }
+
+    /**
+     * @brief Move the contents into a `String`, leaving the builder empty.
+     *      The buffer (and the allocator that owns it) is handed over as is.
+     */
+    String build() {
+        if (Buffer == nullptr)
+            return String(Alloc);
+
+        String out(Buffer, Length, Capacity, Alloc);
+        Buffer = nullptr;
+        Length = 0;
+        Capacity = 0;
+        return out;
+    }
+
+private:
+    // Make room for `numBytes` more bytes, at least doubling the capacity.
+    bool grow(uint64_t numBytes) {
+        uint64_t needed = Length + numBytes;
+        if (needed <= Capacity) return true;
+
+        uint64_t capacity = Capacity ? Capacity * 2 : STRING_BUILDER_INITIAL_CAPACITY;
+        return reserve(needed > capacity ? needed : capacity);
+    }
+
+    uint8_t* Buffer{nullptr};
+    uint64_t Length{0};
+    // Bytes `Buffer` can hold, not counting the NUL terminator.
+    uint64_t Capacity{0};
+    // `nullptr` means the heap.
+    Allocator* Alloc{nullptr};
+};
+
+#endif  // !_STRING_BUILDER_HPP
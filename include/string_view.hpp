@@ -0,0 +1,121 @@
+#ifndef _STRING_VIEW_HPP
+#define _STRING_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A non-owning reference to `Length` characters at `Data`.
+ *
+ *  Views are two words, cheap to pass by value, and never allocate. The
+ *  characters are not necessarily NUL-terminated, so use `length()`
+ *  rather than scanning for the end.
+ */
+class StringView {
+public:
+    static constexpr uint64_t npos = ~0ull;
+
+    constexpr StringView() {}
+
+    constexpr StringView(const char* data, uint64_t length)
+        : Data(data), Length(length) {}
+
+    // Measured at compile time when `cstr` is a literal.
+    constexpr StringView(const char* cstr) : Data(cstr), Length(measure(cstr)) {}
+
+    constexpr const char* data() const { return Data; }
+    const uint8_t* bytes() const { return (const uint8_t*)Data; }
+    constexpr uint64_t length() const { return Length; }
+    constexpr bool empty() const { return Length == 0; }
+
+    constexpr char operator[](uint64_t index) const { return Data[index]; }
+
+    constexpr const char* begin() const { return Data; }
+    constexpr const char* end() const { return Data + Length; }
+
+    // @return the index of the first `c` at or after `from`, or `npos`.
+    constexpr uint64_t find(char c, uint64_t from = 0) const {
+        for (uint64_t i = from; i < Length; ++i)
+            if (Data[i] == c)
+                return i;
+
+        return npos;
+    }
+
+    // @return the index of the first occurrence of `needle` at or after `from`, or `npos`.
+    constexpr uint64_t find(StringView needle, uint64_t from = 0) const {
+        if (needle.Length > Length)
+            return npos;
+
+        for (uint64_t i = from; i + needle.Length <= Length; ++i)
+            if (substr(i, needle.Length) == needle)
+                return i;
+
+        return npos;
+    }
+
+    // @return up to `count` characters starting at `position`.
+    constexpr StringView substr(uint64_t position, uint64_t count = npos) const {
+        if (position > Length)
+            position = Length;
+        if (count > Length - position)
+            count = Length - position;
+
+        return StringView(Data + position, count);
+    }
+
+    constexpr bool starts_with(StringView prefix) const {
+        return prefix.Length <= Length && substr(0, prefix.Length) == prefix;
+    }
+
+    constexpr bool ends_with(StringView suffix) const {
+        return suffix.Length <= Length && substr(Length - suffix.Length) == suffix;
+    }
+
+    /**
+     * @return zero if equal; otherwise negative if this view orders
+     *      before `other` (bytewise, shorter first on a common prefix).
+     */
+    constexpr int compare(StringView other) const {
+        uint64_t common = Length < other.Length ? Length : other.Length;
+        for (uint64_t i = 0; i < common; ++i)
+            if (Data[i] != other.Data[i])
+                return (uint8_t)Data[i] < (uint8_t)other.Data[i] ? -1 : 1;
+
+        if (Length == other.Length)
+            return 0;
+        return Length < other.Length ? -1 : 1;
+    }
+
+    constexpr bool operator==(StringView other) const {
+        if (Length != other.Length)
+            return false;
+
+        for (uint64_t i = 0; i < Length; ++i)
+            if (Data[i] != other.Data[i])
+                return false;
+
+        return true;
+    }
+
+    constexpr bool operator!=(StringView other) const { return !(*this == other); }
+
+private:
+    static constexpr uint64_t measure(const char* cstr) {
+        uint64_t length = 0;
+        if (cstr)
+            while (cstr[length] != '\0')
+                ++length;
+
+        return length;
+    }
+
+    const char* Data{nullptr};
+    uint64_t Length{0};
+};
+
+constexpr StringView operator""_sv(const char* literal, size_t length) {
+    return StringView(literal, length);
+}
+
+#endif  // !_STRING_VIEW_HPP
@@ -0,0 +1,122 @@
+#ifndef _TRACE_HPP
+#define _TRACE_HPP
+
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <kernel/commands.hpp>
+#include <ring_buffer.hpp>
+#include <static_key.hpp>
+
+// Events each processor's trace buffer holds before dropping new ones (a power of two).
+#ifndef TRACE_BUFFER_SLOTS
+#define TRACE_BUFFER_SLOTS 2048
+#endif
+
+// Version of the binary stream written by `Trace::dump()`; see scripts/trace2chrome.py.
+#define TRACE_STREAM_VERSION 1
+
+/**
+ * @brief Kernel paths with a tracepoint, each switched on and off with
+ *      its own static key. Every event has a begin and an end; the
+ *      arguments recorded are:
+ *      Malloc        -- begin: bytes requested, caller    end: address returned
+ *      Free          -- begin: address
+ *      RequestPage   -- end: physical address
+ *      Map           -- begin: virtual address, number of pages (`Memory::map_pages`)
+ *      Interrupt     -- begin/end: IRQ number
+ *      RendererSwap  -- begin: width, height (in pixels)
+ */
+enum class TraceEvent : uint16_t {
+    Malloc = 0,
+    Free,
+    RequestPage,
+    Map,
+    Interrupt,
+    RendererSwap,
+    Count,
+};
+
+enum class TracePhase : uint8_t {
+    Instant = 0,
+    Begin,
+    End,
+};
+
+// One event, exactly as streamed out (little-endian).
+struct TraceRecord {
+    uint64_t Timestamp;
+    uint16_t Event;
+    uint8_t Phase;
+    uint8_t Processor;
+    uint32_t Reserved;
+    uint64_t Args[2];
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord is part of the stream format");
+
+extern StaticKey gTraceKeys[(uint16_t)TraceEvent::Count];
+
+/**
+ * Events recorded on one processor. Only that processor pushes, but an
+ *  interrupt may push in the middle of another push.
+ */
+struct TraceBuffer {
+    RingBuffer<TraceRecord, TRACE_BUFFER_SLOTS, true> Records;
+    // Events lost to a full buffer since the last dump.
+    uint64_t Dropped{0};
+};
+
+extern TraceBuffer gTraceBuffers[CPU_MAX_COUNT];
+
+namespace Trace {
+enum class Output {
+    Serial,
+    Debugcon,
+};
+
+// @return the name of `event`, e.g. "RendererSwap".
+const char* event_name(TraceEvent event);
+
+/**
+ * @brief Append an event, timestamped with the TSC, to this processor's
+ *      trace buffer. Use `TRACE` instead, which skips the call entirely
+ *      while the event is disabled.
+ */
+void record(TraceEvent event, TracePhase phase, uint64_t arg0, uint64_t arg1);
+
+// Start or stop recording `event` by patching its tracepoints.
+void set_enabled(TraceEvent event, bool enabled);
+
+// Start or stop recording every event.
+void set_all_enabled(bool enabled);
+
+/**
+ * @brief Move everything recorded so far out to `output`, as a binary
+ *      stream: a header naming each event, then the records.
+ */
+void dump(Output output);
+
+/**
+ * `trace start [event]`, `trace stop [event]`, `trace dump [serial|debugcon]`
+ *  and `trace list`.
+ */
+extern const Command gCommand;
+}  // namespace Trace
+
+/**
+ * @brief A tracepoint: a 5-byte `nop` until `event` is enabled, and then
+ *      a jump to code that records it with up to two arguments.
+ */
+#define TRACE(event, phase, arg0, arg1)                                                \
+    do {                                                                               \
+        if (STATIC_KEY_ENABLED(gTraceKeys[(uint16_t)TraceEvent::event]))               \
+            Trace::record(TraceEvent::event, TracePhase::phase, (uint64_t)(arg0),      \
+                          (uint64_t)(arg1));                                           \
+    } while (0)
+
+#define TRACE_BEGIN(event, arg0, arg1) TRACE(event, Begin, arg0, arg1)
+#define TRACE_END(event, arg0, arg1) TRACE(event, End, arg0, arg1)
+#define TRACE_INSTANT(event, arg0, arg1) TRACE(event, Instant, arg0, arg1)
+
+#endif  // !_TRACE_HPP
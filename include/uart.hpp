@@ -4,11 +4,18 @@
 #include <cstddef>
 #include <cstdint>
 #include <io/io.hpp>
+#include <string_view.hpp>
 
 #define BAUD_FREQ 115200
-#define BAUD_RATE 9600
+// Set with the `UART_BAUD_RATE` CMake option; must divide `BAUD_FREQ`.
+#ifndef BAUD_RATE
+#define BAUD_RATE 115200
+#endif
 #define BAUD_DIVISOR (BAUD_FREQ / BAUD_RATE)
 
+static_assert(BAUD_RATE > 0 && BAUD_RATE <= BAUD_FREQ && BAUD_FREQ % BAUD_RATE == 0,
+              "BAUD_RATE must divide 115200");
+
 #define COM1 0x3f8
 #define COM2 0x2f8
 
@@ -30,12 +37,13 @@
 #define INTERRUPT_PORT_LINE_STATUS_CHANGED (1 << 2)
 #define INTERRUPT_PORT_MODEM_STATUS_CHANGED (1 << 3)
 
-/**
- * Uncomment the following preprocessor directive to print the
- *  input recieved in COM1 back out to COM1 in the following format.
- *  "[UART]: COM1 INPUT -> <hexadecimal> <integer> <raw byte>" 
- */
-// #define COM1_INPUT_DEBUG
+// Bytes of COM1 input held until the kernel gets around to reading them.
+#define UART_RECEIVE_BUFFER_SIZE 256
+
+// Bytes of COM1 output queued for the transmit interrupt to send.
+#ifndef UART_TRANSMIT_BUFFER_SIZE
+#define UART_TRANSMIT_BUFFER_SIZE 4096
+#endif
 
 /**
  * @brief Port Register Offsets ([PORT] + [OFFSET])
@@ -118,9 +126,40 @@ bool initialized();
 enum class Chip;
 const char* get_uart_chip_name(Chip);
 
-// Called from te UART interrupt handler when data is recieved.
+// Wait for and read a single byte from COM1.
 uint8_t read();
 
+/**
+ * @brief Called from the COM1 interrupt handler, inside a
+ *      `kernel_fpu_begin()` section. Received bytes are moved from the
+ *      chip's FIFO into the receive buffer (dropping what doesn't fit),
+ *      and when the transmitter runs dry it is refilled with up to a
+ *      FIFO's worth of queued output.
+ */
+void handle_interrupt();
+
+/**
+ * @brief Take up to `maxBytes` bytes of buffered COM1 input. Each byte is
+ *      logged as "[UART]: COM1 INPUT -> <hexadecimal> <integer> <raw byte>"
+ *      at `Debug` level.
+ * @return the number of bytes written to `buffer`.
+ */
+uint64_t read_buffered(uint8_t* buffer, uint64_t maxBytes);
+
+/**
+ * @brief Block until everything queued so far has been handed to the
+ *      chip, then write all further output synchronously. For panics,
+ *      where the transmit interrupt may never come.
+ */
+void force_synchronous();
+
+/**
+ * @note Output is queued and sent by the transmit interrupt, so these
+ *      return without waiting on the wire. With interrupts disabled (or
+ *      after `force_synchronous()`) they write straight to the chip
+ *      instead, after whatever was already queued.
+ */
+
 // Write a singular byte verbatim to serial output
 void out(uint8_t);
 
@@ -134,6 +173,12 @@ void out(const char* string);
 // Write a number of bytes from a given buffer to serial output.
 void out(uint8_t* buffer, uint64_t numberOfBytes);
 
+// Write the characters of `text` to serial output.
+void out(StringView text);
+
+// Write binary data as is, without removing anything that looks like a color code.
+void out_raw(const uint8_t* buffer, uint64_t numberOfBytes);
+
 // Write the given number as a string to serial output.
 void out(uint64_t);
 void out(uint32_t);
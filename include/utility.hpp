@@ -0,0 +1,52 @@
+#ifndef _UTILITY_HPP
+#define _UTILITY_HPP
+
+#include <cstdint>
+
+// Freestanding stand-ins for the parts of <utility> the kernel needs.
+
+template <typename T> struct RemoveReference {
+    typedef T Type;
+};
+template <typename T> struct RemoveReference<T&> {
+    typedef T Type;
+};
+template <typename T> struct RemoveReference<T&&> {
+    typedef T Type;
+};
+
+template <typename T>
+constexpr typename RemoveReference<T>::Type&& move(T&& value) noexcept {
+    return static_cast<typename RemoveReference<T>::Type&&>(value);
+}
+
+template <typename T>
+constexpr T&& forward(typename RemoveReference<T>::Type& value) noexcept {
+    return static_cast<T&&>(value);
+}
+template <typename T>
+constexpr T&& forward(typename RemoveReference<T>::Type&& value) noexcept {
+    return static_cast<T&&>(value);
+}
+
+template <typename T> void swap(T& a, T& b) {
+    T tmp = move(a);
+    a = move(b);
+    b = move(tmp);
+}
+
+/**
+ * @return the object whose `Member` is `*member`, for intrusive containers
+ *      that only hold pointers to an embedded node.
+ */
+template <typename T, typename M> T* owner_of(M* member, M T::*Member) {
+    // Offset of `Member` within `T`, taken from a (never dereferenced) null `T`.
+    uint64_t offset = (uint64_t)&(((T*)nullptr)->*Member);
+    return (T*)((uint64_t)member - offset);
+}
+
+template <typename T, typename M> const T* owner_of(const M* member, M T::*Member) {
+    return owner_of((M*)member, Member);
+}
+
+#endif  // !_UTILITY_HPP
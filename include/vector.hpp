@@ -0,0 +1,231 @@
+#ifndef _VECTOR_HPP
+#define _VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory/allocator.hpp>
+#include <memory/heap.hpp>
+#include <memory/memory.hpp>
+#include <utility.hpp>
+
+// Capacity of a vector's first allocated buffer.
+#ifndef VECTOR_INITIAL_CAPACITY
+#define VECTOR_INITIAL_CAPACITY 8
+#endif
+
+/**
+ * @brief A contiguous, growable array of `T`.
+ *
+ *  The first `InlineCapacity` elements are stored inside the vector
+ *  itself, so small vectors never allocate. Past that, elements live in a
+ *  buffer from `Alloc` that doubles whenever it runs out of room, making
+ *  appends amortised O(1). Trivially copyable elements are relocated with
+ *  `memcpy`; anything else is move-constructed into its new slot.
+ *
+ * @note Pointers to elements are invalidated whenever the vector grows.
+ */
+template <typename T, uint64_t InlineCapacity = 0> class Vector {
+public:
+    Vector() = default;
+
+    // Allocate from `allocator` instead of the heap (see `Allocator`).
+    explicit Vector(Allocator* allocator) : Alloc(allocator) {}
+
+    Vector(const Vector& other, Allocator* allocator = nullptr) : Alloc(allocator) {
+        if (!reserve(other.Length))
+            return;
+
+        for (uint64_t i = 0; i < other.Length; ++i)
+            new (&Data[i]) T(other.Data[i]);
+        Length = other.Length;
+    }
+
+    // The buffer (and the allocator that owns it) is taken over.
+    Vector(Vector&& other) noexcept : Alloc(other.Alloc) { take(other); }
+
+    ~Vector() { release(); }
+
+    Vector& operator=(const Vector& other) {
+        if (this == &other) return *this;
+
+        clear();
+        if (!reserve(other.Length))
+            return *this;
+
+        for (uint64_t i = 0; i < other.Length; ++i)
+            new (&Data[i]) T(other.Data[i]);
+        Length = other.Length;
+        return *this;
+    }
+
+    Vector& operator=(Vector&& other) noexcept {
+        if (this == &other) return *this;
+
+        release();
+        Alloc = other.Alloc;
+        take(other);
+        return *this;
+    }
+
+    uint64_t length() const { return Length; }
+    uint64_t capacity() const { return Capacity; }
+    bool empty() const { return Length == 0; }
+
+    T* data() { return Data; }
+    const T* data() const { return Data; }
+
+    T* begin() { return Data; }
+    T* end() { return Data + Length; }
+    const T* begin() const { return Data; }
+    const T* end() const { return Data + Length; }
+
+    T& operator[](uint64_t index) { return Data[index]; }
+    const T& operator[](uint64_t index) const { return Data[index]; }
+
+    T& front() { return Data[0]; }
+    T& back() { return Data[Length - 1]; }
+
+    /**
+     * @brief Make room for at least `capacity` elements.
+     * @return false if the buffer could not be allocated.
+     */
+    bool reserve(uint64_t capacity) {
+        if (capacity <= Capacity) return true;
+
+        T* newData = (T*)allocate(Alloc, capacity * sizeof(T));
+        if (newData == nullptr) return false;
+
+        relocate(Data, newData, Length);
+        free_data();
+        Data = newData;
+        Capacity = capacity;
+        return true;
+    }
+
+    /**
+     * @brief Construct a `T` from `args` at the end of the vector.
+     * @return the new element, or `nullptr` if the vector could not grow.
+     */
+    template <typename... Args> T* emplace_back(Args&&... args) {
+        if (Length < Capacity) {
+            T* element = new (&Data[Length]) T(forward<Args>(args)...);
+            Length++;
+            return element;
+        }
+
+        // Construct into the new buffer before relocating, since `args`
+        // may refer to an element of this vector.
+        uint64_t capacity = Capacity > VECTOR_INITIAL_CAPACITY / 2 ? Capacity * 2
+                                                                   : VECTOR_INITIAL_CAPACITY;
+        T* newData = (T*)allocate(Alloc, capacity * sizeof(T));
+        if (newData == nullptr) return nullptr;
+
+        T* element = new (&newData[Length]) T(forward<Args>(args)...);
+        relocate(Data, newData, Length);
+        free_data();
+        Data = newData;
+        Capacity = capacity;
+        Length++;
+        return element;
+    }
+
+    bool push_back(const T& value) { return emplace_back(value) != nullptr; }
+    bool push_back(T&& value) { return emplace_back(move(value)) != nullptr; }
+
+    void pop_back() {
+        if (Length == 0) return;
+
+        Length--;
+        Data[Length].~T();
+    }
+
+    // Remove the element at `index`, shifting the ones after it down.
+    bool remove(uint64_t index) {
+        if (index >= Length) return false;
+
+        for (uint64_t i = index; i + 1 < Length; ++i)
+            Data[i] = move(Data[i + 1]);
+        pop_back();
+        return true;
+    }
+
+    // Remove the element at `index` by moving the last element into its place.
+    bool remove_unordered(uint64_t index) {
+        if (index >= Length) return false;
+
+        if (index != Length - 1)
+            Data[index] = move(Data[Length - 1]);
+        pop_back();
+        return true;
+    }
+
+    // Destruct every element, keeping the buffer.
+    void clear() {
+        for (uint64_t i = 0; i < Length; ++i)
+            Data[i].~T();
+        Length = 0;
+    }
+
+    Allocator* allocator() const { return Alloc; }
+
+private:
+    static constexpr bool TriviallyCopyable = __is_trivially_copyable(T);
+
+    T* inline_data() { return InlineCapacity ? (T*)Inline : nullptr; }
+    bool is_inline() const { return InlineCapacity && Data == (const T*)Inline; }
+
+    // Move `count` elements from `from` to uninitialized storage at `to`.
+    static void relocate(T* from, T* to, uint64_t count) {
+        if (count == 0) return;
+
+        if (TriviallyCopyable) {
+            memcpy(from, to, count * sizeof(T));
+            return;
+        }
+
+        for (uint64_t i = 0; i < count; ++i) {
+            new (&to[i]) T(move(from[i]));
+            from[i].~T();
+        }
+    }
+
+    void free_data() {
+        if (Data && !is_inline())
+            deallocate(Alloc, Data);
+    }
+
+    // Destruct everything and go back to the inline buffer (if any).
+    void release() {
+        clear();
+        free_data();
+        Data = inline_data();
+        Capacity = InlineCapacity;
+    }
+
+    // Steal `other`'s elements, leaving it empty. `Alloc` must already match.
+    void take(Vector& other) {
+        if (other.is_inline()) {
+            relocate(other.Data, Data, other.Length);
+            Length = other.Length;
+            other.Length = 0;
+            return;
+        }
+
+        Data = other.Data;
+        Length = other.Length;
+        Capacity = other.Capacity;
+
+        other.Data = other.inline_data();
+        other.Length = 0;
+        other.Capacity = InlineCapacity;
+    }
+
+    T* Data{inline_data()};
+    uint64_t Length{0};
+    uint64_t Capacity{InlineCapacity};
+    // `nullptr` means the heap.
+    Allocator* Alloc{nullptr};
+    alignas(T) uint8_t Inline[InlineCapacity ? InlineCapacity * sizeof(T) : 1];
+};
+
+#endif  // !_VECTOR_HPP
@@ -0,0 +1,160 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstdint>
+#include <debug.hpp>
+#include <io/pit.hpp>
+
+namespace CPU {
+Features sFeatures;
+uint64_t sTSCFrequency{0};
+
+static bool bit(uint32_t value, uint8_t index) {
+    return value & (1u << index);
+}
+
+// Store a register's four characters in `out`, lowest byte first.
+static void store_string(char* out, uint32_t value) {
+    for (uint8_t i = 0; i < 4; ++i)
+        out[i] = (char)(value >> (i * 8));
+}
+
+void detect_features() {
+    Features& f = sFeatures;
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t ecx;
+    uint32_t edx;
+
+    cpuid(0, 0, eax, ebx, ecx, edx);
+    f.MaxLeaf = eax;
+    store_string(&f.Vendor[0], ebx);
+    store_string(&f.Vendor[4], edx);
+    store_string(&f.Vendor[8], ecx);
+    f.Vendor[12] = '\0';
+
+    if (f.MaxLeaf >= 1) {
+        cpuid(1, 0, eax, ebx, ecx, edx);
+        f.Stepping = eax & 0xf;
+        f.Model = (eax >> 4) & 0xf;
+        f.Family = (eax >> 8) & 0xf;
+        if (f.Family == 0xf)
+            f.Family += (eax >> 20) & 0xff;
+        if (f.Family == 0x6 || f.Family >= 0xf)
+            f.Model |= ((eax >> 16) & 0xf) << 4;
+
+        f.FPU = bit(edx, 0);
+        f.TSC = bit(edx, 4);
+        f.MSR = bit(edx, 5);
+        f.APIC = bit(edx, 9);
+        f.PGE = bit(edx, 13);
+        f.PAT = bit(edx, 16);
+        f.FXSR = bit(edx, 24);
+        f.SSE = bit(edx, 25);
+        f.SSE2 = bit(edx, 26);
+
+        f.SSE3 = bit(ecx, 0);
+        f.SSSE3 = bit(ecx, 9);
+        f.SSE4_1 = bit(ecx, 19);
+        f.SSE4_2 = bit(ecx, 20);
+        f.PCID = bit(ecx, 17);
+        f.x2APIC = bit(ecx, 21);
+        f.POPCNT = bit(ecx, 23);
+        f.TSCDeadline = bit(ecx, 24);
+        f.XSAVE = bit(ecx, 26);
+        f.OSXSAVE = bit(ecx, 27);
+        f.AVX = bit(ecx, 28);
+        f.RDRAND = bit(ecx, 30);
+    }
+
+    if (f.MaxLeaf >= 7) {
+        cpuid(7, 0, eax, ebx, ecx, edx);
+        f.FSGSBASE = bit(ebx, 0);
+        f.BMI1 = bit(ebx, 3);
+        f.AVX2 = bit(ebx, 5);
+        f.SMEP = bit(ebx, 7);
+        f.BMI2 = bit(ebx, 8);
+        f.ERMS = bit(ebx, 9);
+        f.INVPCID = bit(ebx, 10);
+        f.AVX512F = bit(ebx, 16);
+        f.SMAP = bit(ebx, 20);
+        f.FSRM = bit(edx, 4);
+    }
+
+    if (f.MaxLeaf >= 0xd && f.XSAVE) {
+        cpuid(0xd, 1, eax, ebx, ecx, edx);
+        f.XSAVEOPT = bit(eax, 0);
+    }
+
+    cpuid(0x80000000, 0, eax, ebx, ecx, edx);
+    f.MaxExtendedLeaf = eax;
+
+    if (f.MaxExtendedLeaf >= 0x80000001) {
+        cpuid(0x80000001, 0, eax, ebx, ecx, edx);
+        f.LZCNT = bit(ecx, 5);
+        f.NX = bit(edx, 20);
+        f.Page1GB = bit(edx, 26);
+        f.RDTSCP = bit(edx, 27);
+    }
+
+    if (f.MaxExtendedLeaf >= 0x80000004) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            cpuid(0x80000002 + i, 0, eax, ebx, ecx, edx);
+            store_string(&f.Brand[(i * 16) + 0], eax);
+            store_string(&f.Brand[(i * 16) + 4], ebx);
+            store_string(&f.Brand[(i * 16) + 8], ecx);
+            store_string(&f.Brand[(i * 16) + 12], edx);
+        }
+    }
+    f.Brand[48] = '\0';
+
+    if (f.MaxExtendedLeaf >= 0x80000007) {
+        cpuid(0x80000007, 0, eax, ebx, ecx, edx);
+        f.InvariantTSC = bit(edx, 8);
+    }
+
+    // XCR0 bits 1 and 2: SSE and AVX state are saved/restored by XSAVE.
+    f.AVXUsable = f.AVX && f.OSXSAVE && (xgetbv(0) & 0b110) == 0b110;
+}
+
+const Features& features() {
+    return sFeatures;
+}
+
+void print_features() {
+    const Features& f = sFeatures;
+    dbgmsg("[CPU]: ", f.Brand, " (", f.Vendor, ")\r\n",
+           "  Family ", f.Family, ", Model ", f.Model, ", Stepping ", f.Stepping, "\r\n",
+           "  SSE3: ", f.SSE3, ", SSSE3: ", f.SSSE3, ", SSE4.1: ", f.SSE4_1,
+           ", SSE4.2: ", f.SSE4_2, ", POPCNT: ", f.POPCNT, ", LZCNT: ", f.LZCNT, "\r\n",
+           "  AVX: ", f.AVX, " (usable: ", f.AVXUsable, "), AVX2: ", f.AVX2,
+           ", AVX-512F: ", f.AVX512F, "\r\n",
+           "  XSAVE: ", f.XSAVE, ", XSAVEOPT: ", f.XSAVEOPT, ", ERMS: ", f.ERMS,
+           ", FSRM: ", f.FSRM, "\r\n",
+           "  PCID: ", f.PCID, ", INVPCID: ", f.INVPCID, ", 1GiB pages: ", f.Page1GB,
+           ", NX: ", f.NX, "\r\n",
+           "  TSC-deadline: ", f.TSCDeadline, ", Invariant TSC: ", f.InvariantTSC,
+           ", x2APIC: ", f.x2APIC, "\r\n"
+           "\r\n");
+}
+
+void calibrate_tsc() {
+    sTSCFrequency = PIT::measure_tsc_frequency();
+    if (sTSCFrequency == 0) {
+        dbgmsg_s("[CPU]: \033[31mCould not calibrate the TSC\033[0m\r\n");
+        return;
+    }
+
+    dbgmsg("[CPU]: TSC runs at ", sTSCFrequency / 1000, " kHz",
+           sFeatures.InvariantTSC ? "\r\n" : " (not invariant)\r\n");
+}
+
+uint64_t tsc_frequency() {
+    return sTSCFrequency;
+}
+
+uint64_t tsc_to_microseconds(uint64_t ticks) {
+    if (sTSCFrequency == 0)
+        return 0;
+    // Split up to avoid overflowing for long intervals.
+    return ticks / sTSCFrequency * 1000000 + ticks % sTSCFrequency * 1000000 / sTSCFrequency;
+}
+}  // namespace CPU
@@ -0,0 +1,117 @@
+#include <arch/x86_64/cpu.hpp>
+#include <arch/x86_64/fpu.hpp>
+#include <cstdint>
+#include <debug.hpp>
+#include <panic/panic.hpp>
+
+#define CR0_MP (1ull << 1)
+#define CR0_EM (1ull << 2)
+#define CR0_TS (1ull << 3)
+#define CR0_NE (1ull << 5)
+
+#define CR4_OSFXSR (1ull << 9)
+#define CR4_OSXMMEXCPT (1ull << 10)
+#define CR4_OSXSAVE (1ull << 18)
+
+#define XCR0_X87 (1ull << 0)
+#define XCR0_SSE (1ull << 1)
+#define XCR0_AVX (1ull << 2)
+
+// Legacy FXSAVE image; also the minimum the areas must hold.
+#define FXSAVE_AREA_SIZE 512
+
+// All exceptions masked, round to nearest.
+#define MXCSR_DEFAULT 0x1f80
+
+namespace FPU {
+uint64_t sSaveAreaSize{0};
+
+static uint64_t read_cr0() {
+    uint64_t value;
+    asm volatile("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static void write_cr0(uint64_t value) {
+    asm volatile("mov %0, %%cr0" ::"r"(value));
+}
+
+static uint64_t read_cr4() {
+    uint64_t value;
+    asm volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static void write_cr4(uint64_t value) {
+    asm volatile("mov %0, %%cr4" ::"r"(value));
+}
+
+static void xsetbv(uint32_t index, uint64_t value) {
+    asm volatile("xsetbv" ::"c"(index), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+void initialize() {
+    const CPU::Features& f = CPU::features();
+    if (!f.FXSR || !f.SSE) {
+        dbgmsg_s("[FPU]: \033[31mSSE is not supported\033[0m\r\n");
+        return;
+    }
+
+    // Native x87 error reporting, no emulation, and don't trap on use.
+    uint64_t cr0 = read_cr0();
+    cr0 &= ~(CR0_EM | CR0_TS);
+    cr0 |= CR0_MP | CR0_NE;
+    write_cr0(cr0);
+
+    // FXSAVE/FXRSTOR cover SSE state, and SIMD exceptions raise #XM.
+    uint64_t cr4 = read_cr4();
+    cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+
+    uint64_t xcr0 = XCR0_X87 | XCR0_SSE;
+    if (f.XSAVE) {
+        write_cr4(cr4 | CR4_OSXSAVE);
+
+        uint32_t eax;
+        uint32_t ebx;
+        uint32_t ecx;
+        uint32_t edx;
+        CPU::cpuid(0xd, 0, eax, ebx, ecx, edx);
+        if (f.AVX && (eax & XCR0_AVX))
+            xcr0 |= XCR0_AVX;
+        xsetbv(0, xcr0);
+        gStateMask = xcr0;
+
+        // EBX now reports the area size for the components just enabled.
+        CPU::cpuid(0xd, 0, eax, ebx, ecx, edx);
+        sSaveAreaSize = ebx;
+        gSaveMode = f.XSAVEOPT ? SaveMode::XSAVEOPT : SaveMode::XSAVE;
+    }
+    else {
+        write_cr4(cr4);
+        sSaveAreaSize = FXSAVE_AREA_SIZE;
+        gSaveMode = SaveMode::FXSAVE;
+    }
+
+    if (sSaveAreaSize > FPU_SAVE_AREA_SIZE)
+        panic("FPU save area is too small for the enabled state components");
+
+    uint32_t mxcsr = MXCSR_DEFAULT;
+    asm volatile("fninit\n"
+                 "ldmxcsr %0" ::"m"(mxcsr));
+
+    // `AVXUsable` depends on XCR0.
+    CPU::detect_features();
+
+    dbgmsg("[FPU]: Enabled x87/SSE", xcr0 & XCR0_AVX ? "/AVX" : "", ", saving ",
+           sSaveAreaSize, " bytes with ",
+           gSaveMode == SaveMode::XSAVEOPT ? "XSAVEOPT"
+           : gSaveMode == SaveMode::XSAVE  ? "XSAVE"
+                                           : "FXSAVE",
+           "\r\n"
+           "\r\n");
+}
+
+uint64_t save_area_size() {
+    return sSaveAreaSize;
+}
+}  // namespace FPU
@@ -0,0 +1,79 @@
+#include <arch/x86_64/cpu.hpp>
+#include <arch/x86_64/fpu.hpp>
+#include <cstdint>
+#include <panic/panic.hpp>
+
+namespace FPU {
+SaveMode gSaveMode{SaveMode::None};
+uint64_t gStateMask{0};
+
+/**
+ * @note One area per nesting level. There is only one processor running,
+ *      so these are not per-CPU yet.
+ */
+uint8_t sSaveAreas[FPU_MAX_NESTING][FPU_SAVE_AREA_SIZE] __attribute__((aligned(64)));
+bool sSaved[FPU_MAX_NESTING];
+uint64_t sDepth{0};
+
+static void save(uint8_t* area) {
+    uint32_t low = (uint32_t)gStateMask;
+    uint32_t high = (uint32_t)(gStateMask >> 32);
+    switch (gSaveMode) {
+    case SaveMode::XSAVEOPT:
+        asm volatile("xsaveopt64 %0" : "=m"(*area) : "a"(low), "d"(high) : "memory");
+        break;
+    case SaveMode::XSAVE:
+        asm volatile("xsave64 %0" : "=m"(*area) : "a"(low), "d"(high) : "memory");
+        break;
+    case SaveMode::FXSAVE:
+        asm volatile("fxsave64 %0" : "=m"(*area)::"memory");
+        break;
+    case SaveMode::None:
+        break;
+    }
+}
+
+static void restore(uint8_t* area) {
+    uint32_t low = (uint32_t)gStateMask;
+    uint32_t high = (uint32_t)(gStateMask >> 32);
+    switch (gSaveMode) {
+    case SaveMode::XSAVEOPT:
+    case SaveMode::XSAVE:
+        asm volatile("xrstor64 %0" ::"m"(*area), "a"(low), "d"(high) : "memory");
+        break;
+    case SaveMode::FXSAVE:
+        asm volatile("fxrstor64 %0" ::"m"(*area) : "memory");
+        break;
+    case SaveMode::None:
+        break;
+    }
+}
+}  // namespace FPU
+
+void kernel_fpu_begin() {
+    using namespace FPU;
+
+    // A single instruction, so an interrupt lands either before or after it.
+    uint64_t level = __atomic_fetch_add(&sDepth, 1, __ATOMIC_RELAXED);
+    if (level >= FPU_MAX_NESTING)
+        panic("kernel_fpu_begin: sections nested too deeply");
+
+    // Nested, or in an interrupt or exception handler (their gates clear
+    // IF): someone else's vector state may be live, so always save it.
+    sSaved[level] = level > 0 || !CPU::interrupts_enabled();
+    if (sSaved[level])
+        save(sSaveAreas[level]);
+}
+
+void kernel_fpu_end() {
+    using namespace FPU;
+
+    if (sDepth == 0)
+        panic("kernel_fpu_end: no section is open");
+
+    uint64_t level = sDepth - 1;
+    if (sSaved[level])
+        restore(sSaveAreas[level]);
+
+    __atomic_fetch_sub(&sDepth, 1, __ATOMIC_RELAXED);
+}
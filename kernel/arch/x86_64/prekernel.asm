@@ -27,7 +27,7 @@ prekernel_stack_bottom:
 prekernel_stack_top:
 
 boot_info:
-    resb 48
+    resb 64
 
 SECTION .data
 align 0x1000
@@ -69,7 +69,7 @@ _start:
     mov rbp, rsp
 
     ; Copy boot info structure
-    mov rcx, 48
+    mov rcx, 64
     mov rsi, rdi
     mov rdi, V2P(boot_info)
     cld
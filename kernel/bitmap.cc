@@ -1,3 +1,4 @@
+#include <arch/x86_64/cpu.hpp>
 #include <bitmap.hpp>
 #include <cstdint>
 #include <int.hpp>
@@ -37,4 +38,85 @@ bool Bitmap::set(uint64_t index, bool value) {
     return true;
 }
 
-bool Bitmap::operator[](uint64_t index) { return get(index); }
\ No newline at end of file
+bool Bitmap::operator[](uint64_t index) { return get(index); }
+
+/**
+ * Scans look at 64 bits at a time (and the last few bytes one by one).
+ *  The scan is built twice, counting leading zeros with `bsr`, which
+ *  every CPU has, or with `lzcnt`; `bitmap_select_routines()` binds
+ *  `Bitmap::find()` to one of them at boot.
+ */
+
+// Unaligned, aliasing-safe view of memory.
+typedef uint64_t __attribute__((may_alias, aligned(1))) unaligned_u64;
+
+static uint64_t find_bytewise(const uint8_t* buffer, uint64_t size, bool value,
+                              uint64_t from) {
+    uint64_t bits = size * 8;
+    // Bytes that can't hold a match.
+    uint8_t skip = value ? 0x00 : 0xff;
+
+    for (uint64_t i = from; i < bits;) {
+        if (i % 8 == 0 && buffer[i / 8] == skip) {
+            i += 8;
+            continue;
+        }
+        if ((bool)((buffer[i / 8] >> (7 - (i % 8))) & 1) == value)
+            return i;
+        ++i;
+    }
+    return bits;
+}
+
+/**
+ * Bits are numbered from the most significant bit of each byte, so
+ *  eight bytes loaded big-endian put the first bit of the run at bit 63,
+ *  and the first match is found by counting leading zeros.
+ */
+__attribute__((always_inline)) static inline uint64_t find_qword_impl(const uint8_t* buffer,
+                                                              uint64_t size, bool value,
+                                                              uint64_t from) {
+    // After flipping, the bits being looked for are set.
+    uint64_t flip = value ? 0 : ~0ull;
+    uint64_t byte = from / 8;
+
+    if (byte + 8 <= size) {
+        uint64_t word = __builtin_bswap64(*(const unaligned_u64*)&buffer[byte]) ^ flip;
+        // Ignore the bits before `from`.
+        word &= ~0ull >> (from % 8);
+        if (word)
+            return (byte * 8) + __builtin_clzll(word);
+
+        for (byte += 8; byte + 8 <= size; byte += 8) {
+            word = __builtin_bswap64(*(const unaligned_u64*)&buffer[byte]) ^ flip;
+            if (word)
+                return (byte * 8) + __builtin_clzll(word);
+        }
+        from = byte * 8;
+    }
+
+    return find_bytewise(buffer, size, value, from);
+}
+
+static uint64_t find_qword(const uint8_t* buffer, uint64_t size, bool value, uint64_t from) {
+    return find_qword_impl(buffer, size, value, from);
+}
+
+__attribute__((target("lzcnt"))) static uint64_t find_qword_lzcnt(const uint8_t* buffer,
+                                                                  uint64_t size, bool value,
+                                                                  uint64_t from) {
+    return find_qword_impl(buffer, size, value, from);
+}
+
+static uint64_t (*sBitmapFind)(const uint8_t*, uint64_t, bool, uint64_t){find_qword};
+
+uint64_t Bitmap::find(bool value, uint64_t from) {
+    return sBitmapFind(Buffer, Size, value, from);
+}
+
+void bitmap_select_routines() {
+    if (CPU::features().LZCNT)
+        sBitmapFind = find_qword_lzcnt;
+    else
+        sBitmapFind = find_qword;
+}
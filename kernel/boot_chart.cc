@@ -0,0 +1,67 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <debug.hpp>
+#include <kernel/boot.hpp>
+#include <kernel/boot_chart.hpp>
+#include <string_view.hpp>
+
+struct BootPhase {
+    const char* Name;
+    // Time-stamp counter when the phase ended.
+    uint64_t End;
+};
+
+uint64_t sBootStart{0};
+BootPhase sBootPhases[BOOT_CHART_MAX_PHASES];
+uint64_t sBootPhaseCount{0};
+
+// Width of the name column.
+#define BOOT_CHART_NAME_WIDTH 24
+
+static void print_phase(const char* name, uint64_t ticks, uint64_t totalTicks) {
+    static constexpr StringView padding = "                        ";
+    uint64_t nameLength = StringView(name).length();
+    StringView pad = padding.substr(0, nameLength < BOOT_CHART_NAME_WIDTH
+                                           ? BOOT_CHART_NAME_WIDTH - nameLength
+                                           : 0);
+    uint64_t percent = totalTicks ? ticks * 100 / totalTicks : 0;
+
+    if (CPU::tsc_frequency())
+        dbgmsg("  ", name, pad, CPU::tsc_to_microseconds(ticks), " us  (", percent, "%)\r\n");
+    else
+        dbgmsg("  ", name, pad, ticks, " ticks  (", percent, "%)\r\n");
+}
+
+namespace BootChart {
+void begin() {
+    sBootStart = CPU::rdtsc();
+    sBootPhaseCount = 0;
+}
+
+void mark(const char* phase) {
+    if (sBootPhaseCount < BOOT_CHART_MAX_PHASES)
+        sBootPhases[sBootPhaseCount++] = {phase, CPU::rdtsc()};
+}
+
+void print(const BootInfo* bInfo) {
+    uint64_t end = sBootPhaseCount ? sBootPhases[sBootPhaseCount - 1].End : sBootStart;
+    uint64_t total = end - sBootStart;
+
+    dbgmsg_s("[kstage1]: Boot chart\r\n");
+    // Timestamps from before the kernel are only there if the bootloader took them.
+    if (bInfo->loaderStart && bInfo->loaderExit && bInfo->loaderExit <= sBootStart) {
+        total = end - bInfo->loaderStart;
+        print_phase("bootloader", bInfo->loaderExit - bInfo->loaderStart, total);
+        print_phase("handoff to kstage1", sBootStart - bInfo->loaderExit, total);
+    }
+
+    uint64_t start = sBootStart;
+    for (uint64_t i = 0; i < sBootPhaseCount; ++i) {
+        print_phase(sBootPhases[i].Name, sBootPhases[i].End - start, total);
+        start = sBootPhases[i].End;
+    }
+    print_phase("total", total, total);
+    dbgmsg_s("\r\n");
+}
+}  // namespace BootChart
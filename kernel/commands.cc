@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <cstdint>
+#include <debug.hpp>
+#include <kernel/commands.hpp>
+#include <string_view.hpp>
+#include <uart.hpp>
+
+static void help(StringView);
+
+const Command sHelpCommand{"help", "help", help};
+const Command* sCommands[COMMANDS_MAX] = {&sHelpCommand};
+
+char sCommandLine[COMMAND_LINE_SIZE];
+uint64_t sCommandLineLength{0};
+
+static void help(StringView) {
+    dbgmsg("Commands:\r\n");
+    for (const Command* command : sCommands) {
+        if (command)
+            dbgmsg("  ", command->Usage, "\r\n");
+    }
+}
+
+namespace Commands {
+bool add(const Command* command) {
+    for (const Command*& slot : sCommands) {
+        if (slot == nullptr) {
+            slot = command;
+            return true;
+        }
+    }
+    return false;
+}
+
+StringView next_word(StringView text, uint64_t& position) {
+    while (position < text.length() && text[position] == ' ')
+        position++;
+
+    uint64_t start = position;
+    while (position < text.length() && text[position] != ' ')
+        position++;
+
+    return text.substr(start, position - start);
+}
+
+bool parse_number(StringView text, uint64_t& value) {
+    if (text.empty())
+        return false;
+
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + (uint64_t)(c - '0');
+    }
+    return true;
+}
+
+static void run(StringView line) {
+    uint64_t position = 0;
+    StringView name = next_word(line, position);
+    if (name.empty())
+        return;
+
+    while (position < line.length() && line[position] == ' ')
+        position++;
+    StringView arguments = line.substr(position);
+
+    for (const Command* command : sCommands) {
+        if (command && name == StringView(command->Name)) {
+            command->Run(arguments);
+            return;
+        }
+    }
+    dbgmsg("Unknown command '", name, "'; try 'help'\r\n");
+}
+
+void feed(const uint8_t* input, uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        char c = (char)input[i];
+        if (c == '\r' || c == '\n') {
+            UART::out("\r\n");
+            run(StringView(sCommandLine, sCommandLineLength));
+            sCommandLineLength = 0;
+        } else if (c == '\b' || c == 0x7f) {
+            if (sCommandLineLength) {
+                sCommandLineLength--;
+                UART::out("\b \b");
+            }
+        } else if (c >= ' ' && c <= '~' && sCommandLineLength < COMMAND_LINE_SIZE) {
+            sCommandLine[sCommandLineLength++] = c;
+            UART::outc(c);
+        }
+    }
+}
+}  // namespace Commands
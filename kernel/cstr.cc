@@ -2,8 +2,6 @@
 #include <cstr.hpp>
 #include <uart.hpp>
 
-const char to_hex_not_supported[] = "TYPE_NOT_SUPPORTED";
-
 uint64_t strlen(const char* a) {
     uint64_t out = 0;
 
@@ -32,163 +30,239 @@ const char* to_string(bool b) {
     return b ? trueString : falseString;
 }
 
-char uint_to_str_buf[TO_STRING_BUF_SZ];
-char* to_string(uint64_t value) {
-    // Get necessary string length.
-    uint8_t length = 0;
-    uint64_t val_cpy = value;
+// "00", "01", ... "99": two digits per lookup halves the divisions.
+static const char sDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t sPowersOf10[20] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static const char sHexDigits[] = "0123456789abcdef";
+static const char sHexDigitsCapital[] = "0123456789ABCDEF";
+
+uint8_t count_digits(uint64_t value) {
+    // Zero has as many digits as one, and keeps clz defined.
+    value |= 1;
+    // log10(2) ~= 1233 / 4096, so this is floor(log10(2^bits)): the
+    // digit count, or one short of it.
+    uint32_t bits = 64 - __builtin_clzll(value);
+    uint32_t guess = (bits * 1233) >> 12;
+    return (uint8_t)(guess + (value >= sPowersOf10[guess]));
+}
 
-    while (val_cpy / 10 > 0) {
-        val_cpy /= 10;
-        length++;
+// Write `value` in decimal, ending just before `end`.
+static void write_digits(uint64_t value, char* end) {
+    while (value >= 100) {
+        uint64_t pair = (value % 100) * 2;
+        value /= 100;
+        *--end = sDigitPairs[pair + 1];
+        *--end = sDigitPairs[pair];
     }
 
-    // Write characters to string (in reverse order starting at length).
-    uint8_t index = 0;
+    if (value >= 10) {
+        *--end = sDigitPairs[value * 2 + 1];
+        *--end = sDigitPairs[value * 2];
+    } else
+        *--end = (char)('0' + value);
+}
 
-    while (value / 10 > 0) {
-        uint8_t remainder = value % 10;
-        uint_to_str_buf[length - index] = remainder + '0';
-        value /= 10;
-        index++;
-    }
+uint64_t to_string(uint64_t value, char* buffer) {
+    uint8_t length = count_digits(value);
+    write_digits(value, buffer + length);
+    buffer[length] = '\0';
+    return length;
+}
 
-    // Loop doesn't catch first digit.
-    uint8_t remainder = value % 10;
-    uint_to_str_buf[length - index] = remainder + '0';
+uint64_t to_string(int64_t value, char* buffer) {
+    if (value >= 0)
+        return to_string((uint64_t)value, buffer);
 
-    // Null terminate the string
-    uint_to_str_buf[length + 1] = 0;
-    return uint_to_str_buf;
+    // Negate in unsigned arithmetic so INT64_MIN doesn't overflow.
+    buffer[0] = '-';
+    return 1 + to_string(0 - (uint64_t)value, buffer + 1);
 }
 
-char* to_string(uint32_t value) {
-    return to_string((uint64_t)value);
+static uint64_t copy_word(const char* word, char* buffer) {
+    uint64_t length = 0;
+    for (; word[length]; ++length)
+        buffer[length] = word[length];
+    buffer[length] = '\0';
+    return length;
 }
 
-char* to_string(uint16_t value) {
-    return to_string((uint64_t)value);
+// @return the rounding error of `product`, the double nearest `a * b` (Dekker).
+static double product_error(double a, double b, double product) {
+    // Split each factor into two 26-bit halves whose products are exact.
+    const double split = 134217729.0;  // 2^27 + 1
+    double t = split * a;
+    double aHigh = t - (t - a);
+    double aLow = a - aHigh;
+    t = split * b;
+    double bHigh = t - (t - b);
+    double bLow = b - bHigh;
+    return ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
 }
 
-char* to_string(uint8_t value) {
-    return to_string((uint64_t)value);
+// Write a point and `fraction` as `decimalPlaces` digits (if any). @return the new end.
+static char* write_fraction(uint64_t fraction, uint8_t decimalPlaces, char* out) {
+    if (decimalPlaces == 0)
+        return out;
+
+    *out++ = '.';
+    // Leading zeros of the fraction.
+    uint8_t digits = count_digits(fraction);
+    for (uint8_t i = digits; i < decimalPlaces; ++i)
+        *out++ = '0';
+    write_digits(fraction, out + digits);
+    return out + digits;
 }
 
-char int_to_str_buf[TO_STRING_BUF_SZ];
-char* to_string(int64_t value) {
-    // Add negation symbol before negative values.
-    uint8_t isNegative = 0;
-
-    if (value < 0) {
-        isNegative = 1;
-        value *= -1;
-        int_to_str_buf[0] = '-';
+/**
+ * @brief Round `value` (1e19 or more) to `decimalPlaces` + 1 significant
+ *      digits, half up, in one step: its exact integer value is divided by
+ *      ten until only those digits are left, so no rounding error builds up.
+ * @return the digits; `exponent` is set to the power of ten of the first.
+ */
+static uint64_t round_significand(double value, uint8_t decimalPlaces, uint32_t& exponent) {
+    union {
+        double Value;
+        uint64_t Bits;
+    } pun{value};
+
+    // `value` is exactly mantissa * 2^shift, and 2^63 < 1e19 <= value < 2^1024.
+    uint64_t mantissa = (pun.Bits & ((1ull << 52) - 1)) | (1ull << 52);
+    uint32_t shift = (uint32_t)((pun.Bits >> 52) & 0x7ff) - 1075;
+
+    // 32-bit limbs, least significant first, so each division fits in 64 bits.
+    uint32_t limbs[33];
+    uint32_t used = shift / 32 + 3;
+    for (uint32_t i = 0; i < used; ++i) {
+        uint64_t bit = (uint64_t)i * 32;
+        uint64_t limb = 0;
+        if (bit + 32 > shift && bit < shift + 53)
+            limb = bit >= shift ? mantissa >> (bit - shift) : mantissa << (shift - bit);
+        limbs[i] = (uint32_t)limb;
     }
 
-    // Get necessary string length.
-    uint8_t length = 0;
-    uint64_t val_cpy = value;
+    uint64_t limit = sPowersOf10[decimalPlaces + 1];
+    uint64_t dropped = 0;
+    exponent = decimalPlaces;
+    while (used > 2 || (((uint64_t)limbs[1] << 32) | limbs[0]) >= limit) {
+        uint64_t remainder = 0;
+        for (uint32_t i = used; i-- > 0;) {
+            uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = (uint32_t)(current / 10);
+            remainder = current % 10;
+        }
+        // Only the last (most significant) digit dropped decides the rounding.
+        dropped = remainder;
+        exponent++;
 
-    while (val_cpy / 10 > 0) {
-        val_cpy /= 10;
-        length++;
+        while (used > 2 && limbs[used - 1] == 0)
+            used--;
     }
 
-    // Write characters to string (in reverse order starting at length).
-    uint8_t index = 0;
-
-    while (value / 10 > 0) {
-        uint8_t remainder = value % 10;
-        int_to_str_buf[isNegative + length - index] = remainder + '0';
-        value /= 10;
-        index++;
+    uint64_t digits = ((uint64_t)limbs[1] << 32) | limbs[0];
+    if (dropped >= 5 && ++digits == limit) {
+        digits /= 10;
+        exponent++;
     }
-
-    // Loop doesn't catch first digit.
-    uint8_t remainder = value % 10;
-    int_to_str_buf[isNegative + length - index] = remainder + '0';
-
-    // Null terminate the string
-    int_to_str_buf[isNegative + length + 1] = 0;
-    return int_to_str_buf;
-}
-
-char* to_string(int32_t value) {
-    return to_string((int64_t)value);
-}
-
-char* to_string(int16_t value) {
-    return to_string((int64_t)value);
+    return digits;
 }
 
-char* to_string(int8_t value) {
-    return to_string((int64_t)value);
-}
-
-char dbl_to_str_buf[TO_STRING_BUF_SZ_DBL];
-char* to_string(double value, uint8_t decimalPlaces) {
-    // Max decimal places = 20
-    if (decimalPlaces > 20) {
-        decimalPlaces = 20;
-    }
+uint64_t to_string(double value, char* buffer, uint8_t decimalPlaces) {
+    if (decimalPlaces > TO_STRING_MAX_DECIMALS)
+        decimalPlaces = TO_STRING_MAX_DECIMALS;
 
-    char* int_ptr = (char*)to_string((int64_t)value);
-    char* double_ptr = dbl_to_str_buf;
+    char* out = buffer;
+    if (value != value)
+        return copy_word("nan", out);
 
     if (value < 0) {
-        value *= -1;
+        *out++ = '-';
+        value = -value;
     }
 
-    while (*int_ptr != 0) {
-        *double_ptr = *int_ptr;
-        int_ptr++;
-        double_ptr++;
+    if (value == __builtin_inf())
+        return (out - buffer) + copy_word("inf", out);
+
+    uint64_t scale = sPowersOf10[decimalPlaces];
+
+    // The integer part has to fit in 64 bits, so big values are written
+    // with one digit before the point and an exponent.
+    if (value >= 1e19) {
+        uint32_t exponent;
+        uint64_t digits = round_significand(value, decimalPlaces, exponent);
+        out += to_string(digits / scale, out);
+        out = write_fraction(digits % scale, decimalPlaces, out);
+        *out++ = 'e';
+        *out++ = '+';
+        out += to_string((uint64_t)exponent, out);
+        *out = '\0';
+        return out - buffer;
     }
 
-    *double_ptr = '.';
-    double_ptr++;
-    double newVal = value - (int32_t)value;
-
-    for (uint8_t i = 0; i < decimalPlaces; i++) {
-        newVal *= 10;
-        *double_ptr = (int32_t)newVal + '0';
-        newVal -= (int32_t)newVal;
-        double_ptr++;
+    uint64_t integer = (uint64_t)value;
+    double remainder = value - (double)integer;
+    double scaled = remainder * (double)scale;
+    uint64_t fraction = (uint64_t)scaled;
+
+    // Round half up on the last printed digit. Scaling may itself round up
+    // to exactly one half (0.995 is really 0.99499...), so the product's
+    // rounding error settles ties.
+    double rest = scaled - (double)fraction;
+    if (rest > 0.5 || (rest == 0.5 && product_error(remainder, (double)scale, scaled) >= 0))
+        fraction++;
+
+    // Carry into the integer part.
+    if (fraction >= scale) {
+        fraction -= scale;
+        integer++;
     }
 
-    // Null termination
-    *double_ptr = 0;
-    return dbl_to_str_buf;
+    out += to_string(integer, out);
+    out = write_fraction(fraction, decimalPlaces, out);
+    *out = '\0';
+    return out - buffer;
 }
 
-// Shout-out to User:Pancakes on the osdev wiki!
-// https://wiki.osdev.org/User:Pancakes
-const uint8_t size = 15;
-const char* hexmap = "0123456789abcdef";
-const char* hexmap_capital = "0123456789ABCDEF";
-char hex_to_string_buf[TO_STRING_BUF_SZ];
-
-char* to_hexstring(uint64_t value, bool capital) {
-    int8_t n = (int8_t)size;
-    uint8_t i{0};
-
-    for (; n >= 0; --n) {
-        uint8_t tmp = (value >> (n * 4)) & 0xf;
-        
-        if (capital) {
-            hex_to_string_buf[i] = hexmap_capital[tmp];
-        } else {
-            hex_to_string_buf[i] = hexmap[tmp];
-        }
-        
-        ++i;
-    }
-
-    hex_to_string_buf[i] = 0;
+uint64_t to_hexstring(uint64_t value, char* buffer, bool capital) {
+    const char* digits = capital ? sHexDigitsCapital : sHexDigits;
 
-    return hex_to_string_buf;
-}
+    for (int8_t i = 15; i >= 0; --i) {
+        buffer[i] = digits[value & 0xf];
+        value >>= 4;
+    }
 
-char* to_hexstring(void* ptr, bool capital) {
-    return to_hexstring((uint64_t)ptr, capital);
+    buffer[16] = '\0';
+    return 16;
 }
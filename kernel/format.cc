@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <cstr.hpp>
+#include <format.hpp>
+#include <string.hpp>
+#include <string_view.hpp>
+
+void FormatBuffer::put(char c) {
+    if (Length == Capacity) {
+        if (Sink == nullptr) return;
+        flush();
+    }
+
+    Buffer[Length++] = c;
+}
+
+void FormatBuffer::put(const char* data, uint64_t length) {
+    // Keep the piece whole if it fits in an empty buffer.
+    if (Length + length > Capacity && Sink)
+        flush();
+
+    while (length) {
+        uint64_t room = Capacity - Length;
+        if (room == 0) {
+            if (Sink == nullptr) return;
+            flush();
+            room = Capacity;
+        }
+
+        uint64_t count = length < room ? length : room;
+        for (uint64_t i = 0; i < count; ++i)
+            Buffer[Length + i] = data[i];
+
+        Length += count;
+        data += count;
+        length -= count;
+    }
+}
+
+void FormatBuffer::flush() {
+    if (Sink && Length)
+        Sink(StringView(Buffer, Length));
+
+    Length = 0;
+}
+
+void format_arg(FormatBuffer& out, char value) {
+    out.put(value);
+}
+
+void format_arg(FormatBuffer& out, bool value) {
+    format_arg(out, value ? trueString : falseString);
+}
+
+void format_arg(FormatBuffer& out, const char* value) {
+    if (value == nullptr)
+        value = "(null)";
+
+    uint64_t length = 0;
+    while (value[length])
+        length++;
+
+    out.put(value, length);
+}
+
+void format_arg(FormatBuffer& out, StringView value) {
+    out.put(value.data(), value.length());
+}
+
+void format_arg(FormatBuffer& out, const String& value) {
+    out.put(value.data(), value.length());
+}
+
+void format_arg(FormatBuffer& out, uint64_t value) {
+    char digits[TO_STRING_BUF_SZ];
+    out.put(digits, to_string(value, digits));
+}
+
+void format_arg(FormatBuffer& out, int64_t value) {
+    char digits[TO_STRING_BUF_SZ];
+    out.put(digits, to_string(value, digits));
+}
+
+void format_arg(FormatBuffer& out, double value) {
+    format_arg(out, fixed(value, 2));
+}
+
+void format_arg(FormatBuffer& out, Fixed value) {
+    char digits[TO_STRING_BUF_SZ_DBL];
+    out.put(digits, to_string(value.Value, digits, value.DecimalPlaces));
+}
+
+void format_arg(FormatBuffer& out, Hex value) {
+    char digits[2 + TO_HEXSTRING_BUF_SZ] = {'0', 'x'};
+    out.put(digits, 2 + to_hexstring(value.Value, digits + 2));
+}
+
+void format_arg(FormatBuffer& out, const void* value) {
+    format_arg(out, hex((uint64_t)value));
+}
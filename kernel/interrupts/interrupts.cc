@@ -1,9 +1,13 @@
+#include <arch/x86_64/fpu.hpp>
 #include <cstdint>
 #include <cstr.hpp>
 #include <interrupts/interrupts.hpp>
 #include <io/io.hpp>
+#include <log/deferred.hpp>
 #include <panic/panic.hpp>
+#include <profile/profile.hpp>
 #include <renderer/renderer.hpp>
+#include <trace/trace.hpp>
 #include <uart.hpp>
 
 void enable_interrupt(uint8_t irq) {
@@ -16,6 +20,8 @@ void enable_interrupt(uint8_t irq) {
         port = PIC1_DATA;
     } else {
         irq -= 8;
+        // The secondary PIC only reaches the CPU through the cascade line.
+        enable_interrupt(IRQ_CASCADED_PIC);
     }
 
     uint8_t value = in8(port) & ~IRQ_BIT(irq);
@@ -36,8 +42,8 @@ void disable_interrupt(uint8_t irq) {
 }
 
 void disable_all_interrupts() {
-    out8(PIC1_DATA, 0);
-    out8(PIC2_DATA, 0);
+    out8(PIC1_DATA, 0xff);
+    out8(PIC2_DATA, 0xff);
 }
 
 __attribute__((no_caller_saved_registers)) inline void end_of_interrupt(
@@ -71,15 +77,26 @@ void cause_general_protection() {
 
 // HARDWARE INTERRUPT HANDLERS (IRQs)
 // IRQ0: SYSTEM TIMER
-__attribute__((interrupt)) void system_timer_handler(InterruptFrame* frame) {}
+__attribute__((interrupt)) void system_timer_handler(InterruptFrame* frame) {
+    TRACE_BEGIN(Interrupt, 0, 0);
+    // This handler's frame starts with the interrupted code's frame pointer.
+    Profile::sample(frame->ip, *(uint64_t*)__builtin_frame_address(0));
+    end_of_interrupt(0);
+    TRACE_END(Interrupt, 0, 0);
+}
 
 // IRQ1: PS/2 KEYBOARD
 __attribute__((interrupt)) void keyboard_handler(InterruptFrame* frame) {}
 
-// IRQ4: COM1/COM3 Serial Communications Recieved
+// IRQ4: COM1/COM3 Serial Communications (received data, transmitter empty)
 __attribute__((interrupt)) void uart_com1_handler(InterruptFrame* frame) {
-    uint8_t data = UART::read();
+    TRACE_BEGIN(Interrupt, 4, 0);
+    // The UART driver is built with vector registers enabled.
+    kernel_fpu_begin();
+    UART::handle_interrupt();
+    kernel_fpu_end();
     end_of_interrupt(4);
+    TRACE_END(Interrupt, 4, 0);
 }
 
 /**
@@ -122,6 +139,8 @@ __attribute__((interrupt)) void page_fault_handler(InterruptFrameError* frame) {
     // Collect faulty address as soon as possible (it may be lost quickly).
     uint64_t address;
     asm volatile("mov %%cr2, %0" : "=r"(address));
+    LOG_DEFERRED(Kernel, Error, "[#PF]: address={} error={} ip={}\r\n", hex(address),
+                 hex(frame->error), hex(frame->ip));
     /**
      * US RW P - Description
      * 0  0  0 - Supervisory process tried to read a non-present page entry
@@ -206,12 +225,14 @@ __attribute__((interrupt)) void page_fault_handler(InterruptFrameError* frame) {
         UART::out("  Software gaurd extensions\r\n");
     }
 
+    char hex[TO_HEXSTRING_BUF_SZ];
+    to_hexstring(address, hex);
     UART::out("  Faulty Address: 0x");
-    UART::out(to_hexstring(address));
+    UART::out(hex);
     UART::out("\r\n");
     Vector2<uint64_t> drawPosition = {PanicStartX, PanicStartY};
     gRend.puts(drawPosition, "Faulty Address: 0x", 0x00000000);
-    gRend.puts(drawPosition, to_hexstring(address), 0x00000000);
+    gRend.puts(drawPosition, hex, 0x00000000);
     gRend.swap({PanicStartX, PanicStartY}, {1024, 128});
     while (true)
         asm("hlt");
@@ -244,8 +265,12 @@ __attribute__((interrupt)) void stack_segment_fault_handler(
         UART::out("  LDT");
 
     UART::out(" Selector Index: ");
-    UART::out(to_hexstring(((frame->error & 0b1111111111111000) >> 3)));
+    char index[TO_HEXSTRING_BUF_SZ];
+    to_hexstring((frame->error & 0b1111111111111000) >> 3, index);
+    UART::out(index);
     UART::out("\r\n");
+    while (true)
+        asm("hlt");
 }
 
 __attribute__((interrupt)) void general_protection_fault_handler(
@@ -270,7 +295,9 @@ __attribute__((interrupt)) void general_protection_fault_handler(
     }
 
     UART::out(" Selector Index: ");
-    UART::out(to_hexstring(((frame->error & 0b1111111111111000) >> 3)));
+    char index[TO_HEXSTRING_BUF_SZ];
+    to_hexstring((frame->error & 0b1111111111111000) >> 3, index);
+    UART::out(index);
     UART::out("\r\n");
 
     while (true)
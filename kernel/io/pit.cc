@@ -0,0 +1,49 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <io/io.hpp>
+#include <io/pit.hpp>
+
+namespace PIT {
+uint32_t set_periodic(uint32_t hz) {
+    uint32_t divisor = hz ? PIT_FREQUENCY / hz : 0x10000;
+    if (divisor < 1)
+        divisor = 1;
+    if (divisor > 0x10000)
+        divisor = 0x10000;
+
+    // A divisor of 0 means 65536.
+    out8(PIT_COMMAND, PIT_SELECT_CHANNEL0 | PIT_ACCESS_LOW_HIGH | PIT_MODE_RATE_GENERATOR);
+    out8(PIT_CHANNEL0, (uint8_t)divisor);
+    out8(PIT_CHANNEL0, (uint8_t)(divisor >> 8));
+    return PIT_FREQUENCY / divisor;
+}
+
+uint64_t measure_tsc_frequency() {
+    constexpr uint16_t count = PIT_FREQUENCY / (1000 / PIT_CALIBRATION_MS);
+
+    // Gate channel 2 on, with the speaker disconnected.
+    uint8_t control = in8(PIT_CHANNEL2_CONTROL);
+    out8(PIT_CHANNEL2_CONTROL, (control & ~0x02) | 0x01);
+
+    // Counting starts once the count is written; the output goes high at zero.
+    out8(PIT_COMMAND,
+         PIT_SELECT_CHANNEL2 | PIT_ACCESS_LOW_HIGH | PIT_MODE_INTERRUPT_ON_TERMINAL_COUNT);
+    out8(PIT_CHANNEL2, (uint8_t)count);
+    out8(PIT_CHANNEL2, (uint8_t)(count >> 8));
+
+    uint64_t start = CPU::rdtsc();
+    uint64_t polls = 0;
+    // Each `in8` takes about a microsecond, so give up after ten times as long.
+    while ((in8(PIT_CHANNEL2_CONTROL) & 0x20) == 0) {
+        if (++polls > PIT_CALIBRATION_MS * 10000) {
+            out8(PIT_CHANNEL2_CONTROL, control);
+            return 0;
+        }
+    }
+    uint64_t end = CPU::rdtsc();
+
+    out8(PIT_CHANNEL2_CONTROL, control);
+    return (end - start) * PIT_FREQUENCY / count;
+}
+}  // namespace PIT
@@ -4,10 +4,17 @@
 #include <interrupts/interrupts.hpp>
 #include <cstr.hpp>
 #include <kernel/boot.hpp>
+#include <kernel/commands.hpp>
 #include <debug.hpp>
+#include <log/deferred.hpp>
+#include <log/sinks.hpp>
 #include <renderer/renderer.hpp>
+#include <profile/profile.hpp>
 #include <string.hpp>
+#include <trace/trace.hpp>
 #include <memory/heap.hpp>
+#include <memory/heap_profiler.hpp>
+#include <memory/memory.hpp>
 #include <memory/common.hpp>
 #include <memory/virtual_memory_manager.hpp>
 #include <memory/physical_memory_manager.hpp>
@@ -19,31 +26,38 @@ void print_memory_info(Vector2<uint64_t>& position) {
     uint64_t totalRAM = Memory::total_ram();
     uint64_t freeRAM = Memory::free_ram();
     uint64_t usedRAM = Memory::used_ram();
+    char number[TO_STRING_BUF_SZ];
     
     gRend.puts(position, "Memory Info:");
     
     gRend.crlf(position, startOffset);
     
     gRend.puts(position, "|- Total RAM: ");
-    gRend.puts(position, to_string(TO_MiB(totalRAM)));
+    to_string(TO_MiB(totalRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " MiB (");
-    gRend.puts(position, to_string(TO_KiB(totalRAM)));
+    to_string(TO_KiB(totalRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " KiB)");
     
     gRend.crlf(position, startOffset);
     
     gRend.puts(position, "|- Free RAM: ");
-    gRend.puts(position, to_string(TO_MiB(freeRAM)));
+    to_string(TO_MiB(freeRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " MiB (");
-    gRend.puts(position, to_string(TO_KiB(freeRAM)));
+    to_string(TO_KiB(freeRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " KiB)");
     
     gRend.crlf(position, startOffset);
     
     gRend.puts(position, "`- Used RAM: ");
-    gRend.puts(position, to_string(TO_MiB(usedRAM)));
+    to_string(TO_MiB(usedRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " MiB (");
-    gRend.puts(position, to_string(TO_KiB(usedRAM)));
+    to_string(TO_KiB(usedRAM), number);
+    gRend.puts(position, number);
     gRend.puts(position, " KiB)");
     
     gRend.crlf(position, startOffset);
@@ -76,7 +90,27 @@ extern "C" void kmain(BootInfo* bInfo) {
 
     uint32_t debugInfoX = gRend.Target->PixelWidth - 300;
 
+    // Show warnings and errors below the banner, left of the debug info.
+    Log::console_initialize({0, drawPosition.y},
+                            {debugInfoX, gRend.Target->PixelHeight - drawPosition.y});
+
+    // Commands are typed over COM1; see `help`.
+    Commands::add(&Trace::gCommand);
+    Commands::add(&Profile::gCommand);
+    Commands::add(&gHeapProfilerCommand);
+    Commands::add(&gHeapBenchmarkCommand);
+    Commands::add(&gMemoryBenchmarkCommand);
+
     while(true) {
+        // Run any commands completed since the last pass.
+        uint8_t input[64];
+        uint64_t count;
+        while ((count = UART::read_buffered(input, sizeof(input))))
+            Commands::feed(input, count);
+
+        // Write out what interrupt handlers logged since the last pass.
+        Log::flush_deferred();
+
         drawPosition = {debugInfoX, 0};
 
         // Print Memory Info
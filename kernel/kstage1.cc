@@ -1,3 +1,5 @@
+#include <arch/x86_64/cpu.hpp>
+#include <arch/x86_64/fpu.hpp>
 #include <arch/x86_64/gdt.hpp>
 #include <bitmap.hpp>
 #include <cstddef>
@@ -9,8 +11,10 @@
 #include <interrupts/interrupts.hpp>
 #include <io/io.hpp>
 #include <kernel/boot.hpp>
+#include <kernel/boot_chart.hpp>
 #include <kernel/kstage1.hpp>
 #include <link_definitions.hpp>
+#include <log/log.hpp>
 #include <memory/common.hpp>
 #include <memory/efi_memory.hpp>
 #include <memory/heap.hpp>
@@ -33,6 +37,7 @@ void prepare_interrupts() {
     gIDT = IDTR(0x0fff, (uint64_t)&idt_storage[0]);
 
     // Populate Table
+    gIDT.install_handler((uint64_t)system_timer_handler, PIC_IRQ0);
     gIDT.install_handler((uint64_t)uart_com1_handler, PIC_IRQ4);
     gIDT.install_handler((uint64_t)divide_by_zero_handler, 0x00);
     gIDT.install_handler((uint64_t)double_fault_handler, 0x08);
@@ -74,9 +79,6 @@ void draw_boot_gfx() {
     gRend.swap();
 }
 
-// FXSAVE/FXRSTOR instructions require a pointer to a 512-byte region of memory before use.
-uint8_t fxsave_region[512] __attribute__((aligned(16)));
-
 void kstage1(BootInfo* bInfo) {
     /**
      * @brief This function is monstrous, so the functionality is outlined here.
@@ -112,6 +114,7 @@ void kstage1(BootInfo* bInfo) {
 
     // Disable interrupts while doing sensitive operations.
     asm("cli");
+    BootChart::begin();
 
     // Don't even attempt to boot unless boot info exists.
     if (bInfo == nullptr)
@@ -129,33 +132,54 @@ void kstage1(BootInfo* bInfo) {
     gGDTD.Size = sizeof(GDT) - 1;
     gGDTD.Offset = V2P((uint64_t)&gGDT);
     LoadGDT((GDTDescriptor*)V2P(&gGDTD));
+    BootChart::mark("GDT");
 
     // Prepare Interrupt Descriptor Table.
     prepare_interrupts();
+    BootChart::mark("IDT and PIC");
 
     // setup serial communications chip to allow for debug messages ASAP
     UART::initialize();
+    Log::initialize();
     dbgmsg_s(
         "\r\n"
         "!===--- You are now booting into \033[1;33mEterna\033[0m ---===!\r\n"
         "\r\n");
+    BootChart::mark("UART and log");
+
+    // Determine CPU features, enable SSE/AVX, and bind optimized routines to them.
+    CPU::detect_features();
+    FPU::initialize();
+    CPU::print_features();
+    memory_select_routines();
+    bitmap_select_routines();
+    BootChart::mark("CPU features and FPU");
+
+    // Time-stamp counter frequency, so the boot chart (and traces) can be in microseconds.
+    CPU::calibrate_tsc();
+    BootChart::mark("TSC calibration");
 
     // Setup physical memory allocator from EFI memory map
     Memory::init_physical(bInfo->map, bInfo->mapSize, bInfo->mapDescSize);
+    BootChart::mark("physical memory");
 
     // Setup virtual memory (map entire address space as well as kernel).
     Memory::init_virtual();
+    BootChart::mark("virtual memory");
 
     // Setup dynamic memory allocation (`new`, `delete`)
     init_heap();
+    BootChart::mark("heap");
 
     // Create framebuffer renderer.
     dbgmsg_s("[kstage1]: Setting up Graphics Output Protocol Renderer\r\n");
     gRend = Renderer(bInfo->framebuffer, bInfo->font);
     dbgmsg_s("  \033[32mSetup Successful\033[0m\r\n\r\n");
     draw_boot_gfx();
+    BootChart::mark("renderer");
 
-    // Enable IRQ interrupts that will be used.
+    // Mask every IRQ, then unmask only those that will be used. The
+    // timer stays masked until the profiler is started.
     disable_all_interrupts();
     enable_interrupt(IRQ_UART_COM1);
 
@@ -163,6 +187,8 @@ void kstage1(BootInfo* bInfo) {
     // heap_print_debug_summed();
     // Memory::print_debug();
 
+    BootChart::print(bInfo);
+
     // ALlow interrupts to trigger.
     dbgmsg_s("[kstage1]: Enabling interrupts\r\n");
     asm("sti");
@@ -0,0 +1,98 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <format.hpp>
+#include <log/deferred.hpp>
+#include <log/log.hpp>
+#include <string_view.hpp>
+
+// Set while a flush is running.
+bool sFlushingDeferred{false};
+
+namespace Log {
+static FormatSink sink_for(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return level_sink<LogLevel::Trace>;
+    case LogLevel::Debug:
+        return level_sink<LogLevel::Debug>;
+    case LogLevel::Info:
+        return level_sink<LogLevel::Info>;
+    case LogLevel::Warning:
+        return level_sink<LogLevel::Warning>;
+    default:
+        return level_sink<LogLevel::Error>;
+    }
+}
+
+static void format_deferred_arg(FormatBuffer& out, DeferredArgType type, uint64_t bits) {
+    switch (type) {
+    case DeferredArgType::Unsigned:
+        format_arg(out, bits);
+        break;
+    case DeferredArgType::Signed:
+        format_arg(out, (int64_t)bits);
+        break;
+    case DeferredArgType::Hex:
+        format_arg(out, hex(bits));
+        break;
+    case DeferredArgType::Char:
+        format_arg(out, (char)bits);
+        break;
+    case DeferredArgType::Bool:
+        format_arg(out, bits != 0);
+        break;
+    case DeferredArgType::Double:
+        format_arg(out, __builtin_bit_cast(double, bits));
+        break;
+    case DeferredArgType::String:
+        format_arg(out, (const char*)bits);
+        break;
+    }
+}
+
+static void write_record(const DeferredLogRecord& record) {
+    if (!enabled(record.Level))
+        return;
+
+    char line[FORMAT_LINE_SIZE];
+    FormatBuffer out(line, sizeof(line), sink_for(record.Level));
+    format(out, '[', record.Timestamp, "] ");
+
+    uint8_t arg = 0;
+    for (const char* c = record.Format; *c; ++c) {
+        if (c[0] == '{' && c[1] == '}' && arg < record.ArgCount) {
+            format_deferred_arg(out, record.ArgTypes[arg], record.Args[arg]);
+            arg++;
+            c++;
+            continue;
+        }
+        out.put(*c);
+    }
+    out.flush();
+}
+
+static void flush_records() {
+    for (DeferredLog& log : gDeferredLogs) {
+        uint64_t dropped = __atomic_exchange_n(&log.Dropped, 0, __ATOMIC_RELAXED);
+        if (dropped)
+            Log::print<LogLevel::Warning>("[LOG]: ", dropped, " deferred records dropped\r\n");
+
+        DeferredLogRecord record;
+        while (log.Records.pop(record))
+            write_record(record);
+    }
+}
+
+void flush_deferred() {
+    if (__atomic_test_and_set(&sFlushingDeferred, __ATOMIC_ACQUIRE))
+        return;
+
+    flush_records();
+    __atomic_clear(&sFlushingDeferred, __ATOMIC_RELEASE);
+}
+
+void drain_deferred() {
+    flush_records();
+}
+}  // namespace Log
@@ -0,0 +1,129 @@
+#include <cstddef>
+#include <cstdint>
+#include <log/log.hpp>
+#include <log/sinks.hpp>
+#include <string_view.hpp>
+
+LogSink* sSinks[LOG_MAX_SINKS];
+
+// Lowest level any sink takes, so unwanted messages cost one compare.
+LogLevel sMinimumLevel{LogLevel::None};
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return "Trace";
+    case LogLevel::Debug:
+        return "Debug";
+    case LogLevel::Info:
+        return "Info";
+    case LogLevel::Warning:
+        return "Warning";
+    case LogLevel::Error:
+        return "Error";
+    default:
+        return "None";
+    }
+}
+
+const char* log_subsystem_name(LogSubsystem subsystem) {
+    switch (subsystem) {
+    case LogSubsystem::Kernel:
+        return "Kernel";
+    case LogSubsystem::UART:
+        return "UART";
+    case LogSubsystem::PMM:
+        return "PMM";
+    case LogSubsystem::VMM:
+        return "VMM";
+    case LogSubsystem::Heap:
+        return "Heap";
+    default:
+        return "Unknown";
+    }
+}
+
+// @return the `Log::gMasks` bits for `minimum` and every level above it.
+static constexpr uint8_t level_mask(LogLevel minimum) {
+    return (uint8_t)((1u << (uint8_t)LogLevel::None) - (1u << (uint8_t)minimum));
+}
+
+namespace Log {
+static_assert((uint8_t)LogSubsystem::Count == 5, "Give every subsystem a mask");
+uint8_t gMasks[(uint8_t)LogSubsystem::Count] = {
+    level_mask(LOG_LEVEL), level_mask(LOG_LEVEL), level_mask(LOG_LEVEL),
+    level_mask(LOG_LEVEL), level_mask(LOG_LEVEL),
+};
+
+void set_mask(LogSubsystem subsystem, LogLevel minimum) {
+    gMasks[(uint8_t)subsystem] = level_mask(minimum);
+}
+
+static void update_minimum_level() {
+    LogLevel minimum = LogLevel::None;
+    for (LogSink* sink : sSinks) {
+        if (sink && sink->Level < minimum)
+            minimum = sink->Level;
+    }
+    sMinimumLevel = minimum;
+}
+
+void initialize() {
+    add_sink(&gMemorySink);
+#ifdef QEMU
+    add_sink(&gDebugconSink);
+#endif
+    add_sink(&gUARTSink);
+}
+
+bool add_sink(LogSink* sink) {
+    for (LogSink*& slot : sSinks) {
+        if (slot == sink)
+            return true;
+    }
+
+    for (LogSink*& slot : sSinks) {
+        if (slot == nullptr) {
+            slot = sink;
+            update_minimum_level();
+            return true;
+        }
+    }
+    return false;
+}
+
+void remove_sink(LogSink* sink) {
+    for (LogSink*& slot : sSinks) {
+        if (slot == sink)
+            slot = nullptr;
+    }
+    update_minimum_level();
+}
+
+LogSink* find_sink(StringView name) {
+    for (LogSink* sink : sSinks) {
+        if (sink && name == StringView(sink->Name))
+            return sink;
+    }
+    return nullptr;
+}
+
+void set_level(LogSink* sink, LogLevel level) {
+    sink->Level = level;
+    update_minimum_level();
+}
+
+bool enabled(LogLevel level) {
+    return level >= sMinimumLevel && level != LogLevel::None;
+}
+
+void write(LogLevel level, StringView text) {
+    if (!enabled(level) || text.length() == 0)
+        return;
+
+    for (LogSink* sink : sSinks) {
+        if (sink && level >= sink->Level)
+            sink->Write(level, text);
+    }
+}
+}  // namespace Log
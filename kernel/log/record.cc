@@ -0,0 +1,15 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <log/deferred.hpp>
+
+DeferredLog gDeferredLogs[CPU_MAX_COUNT];
+static_assert(constant_initializable<DeferredLog>(), "gDeferredLogs needs a constructor");
+
+namespace Log {
+void push_deferred(const DeferredLogRecord& record) {
+    DeferredLog& log = gDeferredLogs[CPU::current_index()];
+    if (log.Records.push(record) == false)
+        __atomic_fetch_add(&log.Dropped, 1, __ATOMIC_RELAXED);
+}
+}  // namespace Log
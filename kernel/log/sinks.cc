@@ -0,0 +1,142 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <log/log.hpp>
+#include <log/sinks.hpp>
+#include <math.hpp>
+#include <renderer/renderer.hpp>
+#include <string_view.hpp>
+#include <uart.hpp>
+
+MemoryLog gMemoryLog{LOG_MEMORY_MAGIC, 0, {}};
+
+namespace Log {
+static void uart_write(LogLevel, StringView text) {
+    UART::out(text);
+}
+
+void write_debugcon(const void* data, uint64_t count) {
+    // The whole piece in one instruction; QEMU doesn't pace the port.
+    asm volatile("rep outsb"
+                 : "+S"(data), "+c"(count)
+                 : "d"((uint16_t)DEBUGCON_PORT)
+                 : "memory");
+}
+
+static void debugcon_write(LogLevel, StringView text) {
+    write_debugcon(text.data(), text.length());
+}
+
+static void memory_write(LogLevel, StringView text) {
+    // Claim the bytes first, so an interrupt logging meanwhile writes after them.
+    uint64_t start = __atomic_fetch_add(&gMemoryLog.Written, text.length(), __ATOMIC_RELAXED);
+    for (uint64_t i = 0; i < text.length(); ++i)
+        gMemoryLog.Data[(start + i) & (LOG_MEMORY_SIZE - 1)] = text[i];
+}
+
+uint64_t read_memory(char* buffer, uint64_t maxBytes) {
+    uint64_t written = __atomic_load_n(&gMemoryLog.Written, __ATOMIC_RELAXED);
+    uint64_t count = written < LOG_MEMORY_SIZE ? written : LOG_MEMORY_SIZE;
+    if (count > maxBytes)
+        count = maxBytes;
+
+    uint64_t start = written - count;
+    for (uint64_t i = 0; i < count; ++i)
+        buffer[i] = gMemoryLog.Data[(start + i) & (LOG_MEMORY_SIZE - 1)];
+    return count;
+}
+
+Vector2<uint64_t> sConsolePosition;
+Vector2<uint64_t> sConsoleSize;
+Vector2<uint64_t> sConsoleCursor;
+// Set while skipping an ANSI escape sequence, which the console can't show.
+bool sConsoleInEscape{false};
+
+static uint32_t console_color(LogLevel level) {
+    switch (level) {
+    case LogLevel::Error:
+        return 0xffff4040;
+    case LogLevel::Warning:
+        return 0xffffd000;
+    default:
+        return 0xffffffff;
+    }
+}
+
+static void console_write(LogLevel level, StringView text) {
+    // The renderer isn't reentrant, and whatever an interrupt handler
+    // interrupted may be drawing. Handlers' gates clear IF, so leave
+    // anything written with it clear to the other sinks.
+    if (!CPU::interrupts_enabled())
+        return;
+
+    uint64_t lineHeight = gRend.Font->PSF1_Header->CharacterSize;
+    uint64_t right = sConsolePosition.x + sConsoleSize.x;
+    uint64_t bottom = sConsolePosition.y + sConsoleSize.y;
+    uint32_t color = console_color(level);
+
+    // Rows drawn on, to be swapped to the screen at the end.
+    uint64_t dirtyTop = sConsoleCursor.y;
+    uint64_t dirtyBottom = sConsoleCursor.y;
+
+    for (char c : text) {
+        if (sConsoleInEscape) {
+            // A CSI sequence ends with a byte in `@`..`~` (after the `[`).
+            if (c >= '@' && c <= '~' && c != '[')
+                sConsoleInEscape = false;
+            continue;
+        }
+
+        if (c == '\033') {
+            sConsoleInEscape = true;
+            continue;
+        }
+        if (c == '\r') {
+            sConsoleCursor.x = sConsolePosition.x;
+            continue;
+        }
+
+        if (c == '\n' || sConsoleCursor.x + 8 > right) {
+            sConsoleCursor = {sConsolePosition.x, sConsoleCursor.y + lineHeight};
+            if (c == '\n')
+                continue;
+        }
+
+        // Start over at the top once the region is full.
+        if (sConsoleCursor.y + lineHeight > bottom) {
+            gRend.clear(sConsolePosition, sConsoleSize);
+            sConsoleCursor = sConsolePosition;
+            dirtyTop = sConsolePosition.y;
+            dirtyBottom = bottom - lineHeight;
+        }
+
+        if (c == '\t' || c < ' ' || c > '~')
+            c = ' ';
+
+        gRend.drawChar(sConsoleCursor, c, color);
+        sConsoleCursor.x += 8;
+
+        if (sConsoleCursor.y > dirtyBottom)
+            dirtyBottom = sConsoleCursor.y;
+    }
+
+    gRend.swap({sConsolePosition.x, dirtyTop},
+               {sConsoleSize.x, dirtyBottom + lineHeight - dirtyTop});
+}
+
+void console_initialize(Vector2<uint64_t> position, Vector2<uint64_t> size) {
+    sConsolePosition = position;
+    sConsoleSize = size;
+    sConsoleCursor = position;
+    sConsoleInEscape = false;
+
+    gRend.clear(position, size);
+    gRend.swap(position, size);
+    add_sink(&gConsoleSink);
+}
+
+LogSink gUARTSink{"uart", uart_write, LogLevel::Info};
+LogSink gDebugconSink{"debugcon", debugcon_write, LogLevel::Trace};
+LogSink gMemorySink{"memory", memory_write, LogLevel::Trace};
+LogSink gConsoleSink{"console", console_write, LogLevel::Warning};
+}  // namespace Log
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <memory/arena.hpp>
+#include <memory/common.hpp>
+#include <memory/physical_memory_manager.hpp>
+
+static void* arena_allocate(void* context, uint64_t numBytes) {
+    return ((Arena*)context)->allocate(numBytes);
+}
+
+void Arena::init_allocator() {
+    Hook.Allocate = arena_allocate;
+    // Memory is only ever reclaimed by resetting the arena.
+    Hook.Free = nullptr;
+    Hook.Context = this;
+}
+
+void* Arena::allocate(uint64_t numBytes, uint64_t alignment) {
+    if (numBytes == 0)
+        return nullptr;
+
+    uint64_t aligned = ((uint64_t)Cursor + alignment - 1) & ~(alignment - 1);
+    if (aligned + numBytes > (uint64_t)End) {
+        if (!advance(numBytes, alignment))
+            return nullptr;
+
+        aligned = ((uint64_t)Cursor + alignment - 1) & ~(alignment - 1);
+    }
+
+    Used += aligned + numBytes - (uint64_t)Cursor;
+    Cursor = (uint8_t*)(aligned + numBytes);
+    return (void*)aligned;
+}
+
+/**
+ * @brief Move on to the next chunk that can fit `numBytes`, requesting a
+ *      new one at the end of the chain if none of the retained chunks can.
+ */
+bool Arena::advance(uint64_t numBytes, uint64_t alignment) {
+    uint64_t bytesNeeded = sizeof(Chunk) + alignment + numBytes;
+
+    Chunk* previous = Current;
+    Chunk* next = Current ? Current->Next : First;
+
+    // Retained chunks too small for this allocation sit idle until the next reset.
+    while (next && next->NumPages * PAGE_SIZE < bytesNeeded) {
+        previous = next;
+        next = next->Next;
+    }
+
+    if (next == nullptr) {
+        uint64_t numPages = (bytesNeeded + PAGE_SIZE - 1) / PAGE_SIZE;
+        next = (Chunk*)Memory::request_pages(numPages);
+        if (next == nullptr)
+            return false;
+
+        next->Next = nullptr;
+        next->NumPages = numPages;
+        Reserved += numPages * PAGE_SIZE;
+
+        if (previous)
+            previous->Next = next;
+        else
+            First = next;
+    }
+
+    Current = next;
+    Cursor = (uint8_t*)next + sizeof(Chunk);
+    End = (uint8_t*)next + (next->NumPages * PAGE_SIZE);
+    return true;
+}
+
+void Arena::reset() {
+    Current = nullptr;
+    Used = 0;
+
+    if (InitialBuffer) {
+        Cursor = InitialBuffer;
+        End = InitialBuffer + InitialSize;
+    } else {
+        Cursor = nullptr;
+        End = nullptr;
+    }
+}
+
+void Arena::release() {
+    Chunk* it = First;
+    while (it) {
+        Chunk* next = it->Next;
+        Memory::free_pages(it, it->NumPages);
+        it = next;
+    }
+
+    First = nullptr;
+    Reserved = 0;
+    reset();
+}
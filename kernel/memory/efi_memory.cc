@@ -38,14 +38,18 @@ void print_efi_memory_map(EFI_MEMORY_DESCRIPTOR* map, uint64_t mapSize,
         }
         
         UART::out("\r\n  Physical Address: 0x");
-        UART::out(to_hexstring<void*>(desc->PhysicalAddress));
+        char number[TO_STRING_BUF_SZ];
+        to_hexstring(desc->PhysicalAddress, number);
+        UART::out(number);
         UART::out("\r\n  Size: ");
         
         uint64_t sizeKiB = desc->NumPages * PAGE_SIZE / 1024;
         
-        UART::out(to_string(sizeKiB / 1024));
+        to_string(sizeKiB / 1024, number);
+        UART::out(number);
         UART::out("MiB (");
-        UART::out(to_string(sizeKiB));
+        to_string(sizeKiB, number);
+        UART::out(number);
         UART::out("KiB)\033[0m\r\n");
     }
 }
@@ -72,10 +76,13 @@ void print_efi_memory_map_summed(EFI_MEMORY_DESCRIPTOR* map, uint64_t mapSize,
         UART::out("\r\n  Total Size: ");
     
         uint64_t sizeKiB = typePageSums[i] * PAGE_SIZE / 1024;
+        char number[TO_STRING_BUF_SZ];
     
-        UART::out(to_string(sizeKiB / 1024));
+        to_string(sizeKiB / 1024, number);
+        UART::out(number);
         UART::out("MiB (");
-        UART::out(to_string(sizeKiB));
+        to_string(sizeKiB, number);
+        UART::out(number);
         UART::out("KiB)\033[0m\r\n");
     }
 }
@@ -1,16 +1,20 @@
+#include <arch/x86_64/cpu.hpp>
 #include <cstddef>
 #include <cstdint>
 #include <cstr.hpp>
 #include <debug.hpp>
+#include <kernel/commands.hpp>
+#include <log/log.hpp>
+#include <memory/arena.hpp>
 #include <memory/common.hpp>
 #include <memory/heap.hpp>
+#include <memory/heap_profiler.hpp>
 #include <memory/memory.hpp>
 #include <memory/paging.hpp>
 #include <memory/physical_memory_manager.hpp>
 #include <memory/virtual_memory_manager.hpp>
 #include <string.hpp>
-
-#define DEBUG_HEAP
+#include <trace/trace.hpp>
 
 void* sHeapStart{nullptr};
 void* sHeapEnd{nullptr};
@@ -107,33 +111,67 @@ void init_heap() {
     firstSegment->last = nullptr;
     firstSegment->free = true;
     sLastHeader = firstSegment;
-    dbgmsg(
-        "[HEAP]: \033[32mInitialized\033[0m\r\n"
-        "  Virtual Address: %x thru %x\r\n"
-        "  Size: $ull\r\n"
-        "\r\n",
-        sHeapStart, sHeapEnd, numBytes);
+    dbgmsg("[HEAP]: \033[32mInitialized\033[0m\r\n",
+           "  Virtual Address: ", sHeapStart, " thru ", sHeapEnd, "\r\n",
+           "  Size: ", numBytes, "\r\n"
+           "\r\n");
     // heap_print_debug();
 }
 
-void expand_heap(uint64_t numBytes) {
-#ifdef DEBUG_HEAP
-    dbgmsg("[HEAP]: Expanding by %ull bytes\r\n", numBytes);
-#endif
-    uint64_t numPages = (numBytes / PAGE_SIZE) + 1;
-    // Round byte count to page-aligned boundary.
-    numBytes = numPages * PAGE_SIZE;
-    // Get address of new header at the end of the heap.
-    HeapSegmentHeader* extension = (HeapSegmentHeader*)sHeapEnd;
+/**
+ * @brief Back `numPages` pages starting at `virtualAddress` with freshly
+ *      requested physical memory. A single physically contiguous run is
+ *      requested and mapped in one go; if no such run exists, pages are
+ *      requested and mapped one at a time instead.
+ */
+static void map_new_pages(void* virtualAddress, uint64_t numPages) {
+    uint64_t flags = (uint64_t)Memory::PageTableFlag::Present |
+                     (uint64_t)Memory::PageTableFlag::ReadWrite |
+                     (uint64_t)Memory::PageTableFlag::Global;
+
+    if (void* physical = Memory::request_pages(numPages)) {
+        Memory::map_pages(virtualAddress, physical, numPages, flags);
+        return;
+    }
 
-    // Allocate and map a page in memory for new header.
     for (uint64_t i = 0; i < numPages; ++i) {
-        Memory::map(sHeapEnd, Memory::request_page(),
-                    (uint64_t)Memory::PageTableFlag::Present |
-                        (uint64_t)Memory::PageTableFlag::ReadWrite |
-                        (uint64_t)Memory::PageTableFlag::Global);
-        sHeapEnd = (void*)((uint64_t)sHeapEnd + PAGE_SIZE);
+        Memory::map((void*)((uint64_t)virtualAddress + (i * PAGE_SIZE)),
+                    Memory::request_page(), flags);
     }
+}
+
+// Minimum number of pages the next call to `expand_heap` will map.
+uint64_t sHeapExpansionPages{HEAP_INITIAL_PAGES};
+// Pages the last call to `expand_heap` mapped (at most `HEAP_EXPANSION_MAX_PAGES`);
+// `heap_trim` keeps at least this much slack.
+uint64_t sHeapLastExpansionPages{0};
+// How often the heap has grown and shrunk, for `heap_benchmark_trim()`.
+uint64_t sHeapExpansions{0};
+uint64_t sHeapTrims{0};
+
+HeapSegmentHeader* expand_heap(uint64_t numBytes) {
+    // Enough pages to hold a header plus `numBytes` of payload...
+    uint64_t numPages =
+        (numBytes + sizeof(HeapSegmentHeader) + PAGE_SIZE - 1) / PAGE_SIZE;
+    // ...but grow geometrically so a burst of allocations doesn't expand page by page.
+    if (numPages < sHeapExpansionPages)
+        numPages = sHeapExpansionPages;
+
+    sHeapExpansionPages *= 2;
+    if (sHeapExpansionPages > HEAP_EXPANSION_MAX_PAGES)
+        sHeapExpansionPages = HEAP_EXPANSION_MAX_PAGES;
+    // A large request that fell back to the segment heap shouldn't keep
+    // all of its pages mapped after it is freed.
+    sHeapLastExpansionPages =
+        numPages < HEAP_EXPANSION_MAX_PAGES ? numPages : HEAP_EXPANSION_MAX_PAGES;
+    sHeapExpansions++;
+
+    LOG(Heap, Debug, "[HEAP]: Expanding by ", numPages, " pages\r\n");
+    // Get address of new header at the end of the heap.
+    HeapSegmentHeader* extension = (HeapSegmentHeader*)sHeapEnd;
+
+    map_new_pages(sHeapEnd, numPages);
+    sHeapEnd = (void*)((uint64_t)sHeapEnd + (numPages * PAGE_SIZE));
 
     extension->free = true;
     extension->last = sLastHeader;
@@ -142,82 +180,359 @@ void expand_heap(uint64_t numBytes) {
     sLastHeader = extension;
 
     extension->next = nullptr;
-    extension->length = numBytes - sizeof(HeapSegmentHeader);
+    extension->length = (numPages * PAGE_SIZE) - sizeof(HeapSegmentHeader);
 
     // After expanding, combine with the previous segment (Decrease fragmentation).
     extension->combine_backward();
+
+    // Whichever segment the extension ended up in is now the last one.
+    return sLastHeader;
 }
 
-void* malloc(uint64_t numBytes) {
+/**
+ * @brief Unmap `numPages` pages starting at `virtualAddress` and hand the
+ *      physical pages that backed them back to the physical memory manager.
+ *      Physically contiguous runs are freed together.
+ */
+static void release_pages(void* virtualAddress, uint64_t numPages) {
+    uint64_t runStart = 0;
+    uint64_t runLength = 0;
+
+    for (uint64_t i = 0; i < numPages; ++i) {
+        void* page = (void*)((uint64_t)virtualAddress + (i * PAGE_SIZE));
+        uint64_t physical = (uint64_t)Memory::virtual_to_physical(page);
+        Memory::unmap(page);
+
+        if (physical == 0)
+            continue;
+
+        if (runLength > 0 && physical == runStart + (runLength * PAGE_SIZE)) {
+            runLength++;
+            continue;
+        }
+
+        if (runLength > 0)
+            Memory::free_pages((void*)runStart, runLength);
+
+        runStart = physical;
+        runLength = 1;
+    }
+
+    if (runLength > 0)
+        Memory::free_pages((void*)runStart, runLength);
+}
+
+enum class LargeAllocationState {
+    // Slot is not in use.
+    Empty,
+    // Pages are mapped and handed out to a caller.
+    Allocated,
+    // Virtual range was freed and may be handed out again.
+    Hole,
+};
+
+struct LargeAllocation {
+    uint64_t base{0};
+    // Pages of the virtual range this slot owns.
+    uint64_t numPages{0};
+    // Pages actually mapped, from `base`; fewer than `numPages` if a hole was handed out whole.
+    uint64_t mappedPages{0};
+    LargeAllocationState state{LargeAllocationState::Empty};
+#ifdef HEAP_PROFILER
+    void* callsite{nullptr};
+#endif
+};
+
+LargeAllocation sLargeAllocations[HEAP_LARGE_ALLOCATION_SLOTS];
+// Lowest virtual address in the large allocation range never handed out.
+uint64_t sLargeNext{HEAP_LARGE_VIRTUAL_BASE};
+
+static bool is_large_allocation(void* address) {
+    return (uint64_t)address >= HEAP_LARGE_VIRTUAL_BASE &&
+           (uint64_t)address < HEAP_LARGE_VIRTUAL_BASE + HEAP_LARGE_VIRTUAL_SIZE;
+}
+
+static void* allocate_large(uint64_t numBytes) {
+    uint64_t numPages = (numBytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    LargeAllocation* hole{nullptr};
+    LargeAllocation* empty{nullptr};
+
+    for (LargeAllocation& slot : sLargeAllocations) {
+        if (slot.state == LargeAllocationState::Empty && empty == nullptr)
+            empty = &slot;
+
+        if (slot.state == LargeAllocationState::Hole &&
+            slot.numPages >= numPages &&
+            (hole == nullptr || slot.numPages < hole->numPages))
+            hole = &slot;
+    }
+
+    LargeAllocation* allocation{nullptr};
+
+    if (hole && (hole->numPages == numPages || empty == nullptr)) {
+        // An exact fit, or there's no slot to record the remainder in; then
+        // the whole hole goes with the allocation, only partly mapped.
+        allocation = hole;
+    } else if (hole) {
+        // Split the hole; the remainder stays available.
+        empty->base = hole->base + (numPages * PAGE_SIZE);
+        empty->numPages = hole->numPages - numPages;
+        empty->state = LargeAllocationState::Hole;
+        hole->numPages = numPages;
+        allocation = hole;
+    } else if (empty) {
+        uint64_t end = HEAP_LARGE_VIRTUAL_BASE + HEAP_LARGE_VIRTUAL_SIZE;
+        if (sLargeNext + (numPages * PAGE_SIZE) > end)
+            return nullptr;
+
+        empty->base = sLargeNext;
+        empty->numPages = numPages;
+        sLargeNext += numPages * PAGE_SIZE;
+        allocation = empty;
+    } else {
+        // Side table is full.
+        return nullptr;
+    }
+
+    allocation->state = LargeAllocationState::Allocated;
+    allocation->mappedPages = numPages;
+    map_new_pages((void*)allocation->base, numPages);
+
+    LOG(Heap, Debug, "[HEAP]: Large allocation of ", numPages, " pages at ",
+        hex(allocation->base), "\r\n");
+    return (void*)allocation->base;
+}
+
+static LargeAllocation* find_large_allocation(void* address) {
+    for (LargeAllocation& slot : sLargeAllocations) {
+        if (slot.state == LargeAllocationState::Allocated &&
+            slot.base == (uint64_t)address)
+            return &slot;
+    }
+    return nullptr;
+}
+
+static void free_large(void* address) {
+    LargeAllocation* allocation = find_large_allocation(address);
+    if (allocation == nullptr) {
+        dbgmsg("[HEAP]: \033[31mERROR\033[0m:: free() of unknown large allocation ", address,
+               "\r\n");
+        return;
+    }
+
+    release_pages(address, allocation->mappedPages);
+    allocation->state = LargeAllocationState::Hole;
+
+    // Merge with neighbouring holes so the virtual range doesn't fragment.
+    for (LargeAllocation& slot : sLargeAllocations) {
+        if (&slot == allocation || slot.state != LargeAllocationState::Hole)
+            continue;
+
+        if (slot.base + (slot.numPages * PAGE_SIZE) == allocation->base) {
+            slot.numPages += allocation->numPages;
+            allocation->state = LargeAllocationState::Empty;
+            allocation = &slot;
+        }
+    }
+    for (LargeAllocation& slot : sLargeAllocations) {
+        if (&slot == allocation || slot.state != LargeAllocationState::Hole)
+            continue;
+
+        if (allocation->base + (allocation->numPages * PAGE_SIZE) == slot.base) {
+            allocation->numPages += slot.numPages;
+            slot.state = LargeAllocationState::Empty;
+        }
+    }
+
+    // A hole at the top of the range is simply given back to the bump pointer.
+    if (allocation->base + (allocation->numPages * PAGE_SIZE) == sLargeNext) {
+        sLargeNext = allocation->base;
+        allocation->state = LargeAllocationState::Empty;
+    }
+}
+
+void heap_trim() {
+    HeapSegmentHeader* tail = sLastHeader;
+    if (tail == nullptr || tail->free == false)
+        return;
+
+    if (tail->length < HEAP_TRIM_THRESHOLD_PAGES * PAGE_SIZE)
+        return;
+
+    // Keep the tail header (and a minimal payload) mapped, plus enough slack
+    // that the next few allocations don't have to grow the heap right away.
+    // Whatever needed the last expansion is likely to need it again, so
+    // keep at least that much too.
+    uint64_t retainPages = HEAP_TRIM_RETAIN_PAGES;
+    if (retainPages < sHeapLastExpansionPages)
+        retainPages = sHeapLastExpansionPages;
+
+    uint64_t payload = (uint64_t)tail + sizeof(HeapSegmentHeader);
+    uint64_t newEnd = (payload + 8 + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    newEnd += retainPages * PAGE_SIZE;
+
+    // Never shrink below the size the heap started out with.
+    uint64_t minimumEnd = (uint64_t)sHeapStart + (HEAP_INITIAL_PAGES * PAGE_SIZE);
+    if (newEnd < minimumEnd)
+        newEnd = minimumEnd;
+
+    if (newEnd >= (uint64_t)sHeapEnd)
+        return;
+
+    uint64_t numPages = ((uint64_t)sHeapEnd - newEnd) / PAGE_SIZE;
+    LOG(Heap, Debug, "[HEAP]: Trimming ", numPages, " pages\r\n");
+    release_pages((void*)newEnd, numPages);
+
+    sHeapEnd = (void*)newEnd;
+    tail->length = newEnd - payload;
+    sHeapTrims++;
+
+    // The heap just shrank, so the next growth needn't be as aggressive.
+    sHeapExpansionPages /= 2;
+    if (sHeapExpansionPages < HEAP_INITIAL_PAGES)
+        sHeapExpansionPages = HEAP_INITIAL_PAGES;
+}
+
+/**
+ * @brief Hand out the first `numBytes` of `segment`, splitting off the
+ *      remainder as a new free segment if it is large enough to be useful.
+ * @return the payload address, or `nullptr` if `segment` doesn't fit.
+ */
+static void* allocate_from(HeapSegmentHeader* segment, uint64_t numBytes) {
+    if (segment->free == false || segment->length < numBytes)
+        return nullptr;
+
+    if (segment->split(numBytes))
+        LOG(Heap, Trace, "  Made split.\r\n");
+    else
+        LOG(Heap, Trace, "  Found fitting segment.\r\n");
+
+    segment->free = false;
+    return (void*)((uint64_t)segment + sizeof(HeapSegmentHeader));
+}
+
+static void* allocate_bytes(uint64_t numBytes) {
     // can't allocate nothing
     if (numBytes == 0)
         return nullptr;
 
+    // Keep big buffers out of the segment list altogether.
+    if (numBytes >= HEAP_LARGE_ALLOCATION_THRESHOLD) {
+        if (void* large = allocate_large(numBytes))
+            return large;
+    }
+
     // Round numBytes to 64-bit (8-byte) aligned number.
     if (numBytes % 8 > 0) {
         numBytes -= (numBytes % 8);
         numBytes += 8;
     }
 
-#ifdef DEBUG_HEAP
-    dbgmsg("[HEAP]: malloc() -- numBytes=%ull\r\n", numBytes);
-#endif  // DEBUG_HEAP
+    LOG(Heap, Trace, "[HEAP]: malloc() -- numBytes=", numBytes, "\r\n");
 
     // start looking for a free segment at the start of the heap.
     HeapSegmentHeader* current = (HeapSegmentHeader*)sHeapStart;
 
-    while (true) {
-        if (current->free) {
-            if (current->length > numBytes) {
-                if (HeapSegmentHeader* split = current->split(numBytes)) {
-                    split->free = false;
-#ifdef DEBUG_HEAP
-                    dbgmsg("  Made split.\r\n");
-                    heap_print_debug();
-#endif  // DEBUG_HEAP
-                    return (void*)((uint64_t)split + sizeof(HeapSegmentHeader));
-                }
-            } else if (current->length == numBytes) {
-                current->free = false;
-#ifdef DEBUG_HEAP
-                dbgmsg("  Found exact match.\r\n");
-                heap_print_debug();
-#endif  // DEBUG_HEAP
-                return (void*)((uint64_t)current + sizeof(HeapSegmentHeader));
-            }
-        }
-
-        if (current->next == nullptr)
-            break;
+    while (current) {
+        if (void* out = allocate_from(current, numBytes))
+            return out;
 
         current = current->next;
     }
 
     /**
-     * If this point is reached:
-     * 1. No free segment of size has been found
-     * 2. All existing segments have been searched
-     * From here, we must allocate more memory for the heap (expand it),
-     *      then do the same search once again. There is some optimization to be done here.
+     * If this point is reached, every segment has been searched and none
+     * can fit the request. Expand the heap and carve the allocation out of
+     * the new tail segment directly; it is guaranteed to be large enough.
      */
-    expand_heap(numBytes);
+    return allocate_from(expand_heap(numBytes), numBytes);
+}
+
+#ifdef HEAP_PROFILER
+/**
+ * @brief Remember which callsite `address` was allocated from, so that
+ *      `free` can credit the right one later on.
+ * @return the number of bytes the allocation actually occupies.
+ */
+static uint64_t tag_allocation(void* address, void* callsite) {
+    if (is_large_allocation(address)) {
+        LargeAllocation* allocation = find_large_allocation(address);
+        allocation->callsite = callsite;
+        return allocation->mappedPages * PAGE_SIZE;
+    }
+
+    HeapSegmentHeader* segment =
+        (HeapSegmentHeader*)((uint64_t)address - sizeof(HeapSegmentHeader));
+    segment->callsite = callsite;
+    return segment->length;
+}
+
+static void profile_free(void* address) {
+    if (is_large_allocation(address)) {
+        if (LargeAllocation* allocation = find_large_allocation(address)) {
+            heap_profiler_record_free(allocation->callsite,
+                                      allocation->mappedPages * PAGE_SIZE);
+        }
+        return;
+    }
+
+    HeapSegmentHeader* segment =
+        (HeapSegmentHeader*)((uint64_t)address - sizeof(HeapSegmentHeader));
+    heap_profiler_record_free(segment->callsite, segment->length);
+}
+#endif  // HEAP_PROFILER
+
+/**
+ * @brief `malloc`, on behalf of `callsite` (the code that asked for memory,
+ *      as opposed to `operator new` or other wrappers).
+ */
+static void* malloc_impl(uint64_t numBytes, void* callsite) {
+    TRACE_BEGIN(Malloc, numBytes, callsite);
+#ifdef HEAP_PROFILER
+    uint64_t start = CPU::rdtsc();
+    void* out = allocate_bytes(numBytes);
+    if (out) {
+        uint64_t held = tag_allocation(out, callsite);
+        heap_profiler_record_allocation(callsite, held, CPU::rdtsc() - start);
+    }
+#else
+    void* out = allocate_bytes(numBytes);
+#endif  // HEAP_PROFILER
+    TRACE_END(Malloc, out, 0);
+    return out;
+}
 
-    return malloc(numBytes);
+void* malloc(uint64_t numBytes) {
+    return malloc_impl(numBytes, __builtin_return_address(0));
 }
 
 void free(void* address) {
+    // can't free nothing
+    if (address == nullptr)
+        return;
+
+    TRACE_BEGIN(Free, address, 0);
+#ifdef HEAP_PROFILER
+    profile_free(address);
+#endif
+
+    if (is_large_allocation(address)) {
+        free_large(address);
+        TRACE_END(Free, 0, 0);
+        return;
+    }
+
     HeapSegmentHeader* segment =
         (HeapSegmentHeader*)((uint64_t)address - sizeof(HeapSegmentHeader));
-#ifdef HEAP_DEBUG
-    dbgmsg("[HEAP]: free() -- address=%x, numBytes=%ull\r\n", address,
-           segment->length);
-#endif  // HEAP_DEBUG
+    LOG(Heap, Trace, "[HEAP]: free() -- address=", address, ", numBytes=", segment->length,
+        "\r\n");
     segment->free = true;
     segment->combine_forward();
     segment->combine_backward();
-#ifdef HEAP_DEBUG
-    heap_print_debug();
-#endif  // HEAP_DEBUG
+    heap_trim();
+    if (LOG_ENABLED(Heap, Trace))
+        heap_print_debug();
+    TRACE_END(Free, 0, 0);
 }
 
 void heap_print_debug_starchart() {
@@ -226,9 +541,13 @@ void heap_print_debug_starchart() {
 
     uint64_t heapSize = (uint64_t)(sHeapEnd) - (uint64_t)(sHeapStart);
     uint64_t totalChars = heapSize / characterGranularity + 1;
-    uint8_t* out = new uint8_t[totalChars];
+    // The chart goes away with the arena.
+    Arena arena;
+    uint8_t* out = arena.allocate_array<uint8_t>(totalChars + 1);
+    if (out == nullptr)
+        return;
 
-    memset(out, 0, totalChars);
+    memset(out, 0, totalChars + 1);
 
     uint64_t freeLeftover = 0;
     uint64_t usedLeftover = 0;
@@ -265,23 +584,37 @@ void heap_print_debug_starchart() {
         it = it->next;
     } while (it != nullptr);
 
-    String heap_visualization((const char*)out);
-
     dbgmsg_s("Heap (64b per char): ");
-    dbgrainbow(heap_visualization, ShouldNewline::Yes);
+    dbgrainbow(StringView((const char*)out, offset < totalChars ? offset : totalChars),
+               ShouldNewline::Yes);
     dbgmsg_s("\r\n");
 }
 
+void heap_print_debug_large() {
+    uint64_t count = 0;
+    uint64_t totalPages = 0;
+
+    dbgmsg("[Heap]: Large allocations:\r\n");
+    for (LargeAllocation& slot : sLargeAllocations) {
+        if (slot.state != LargeAllocationState::Allocated)
+            continue;
+
+        dbgmsg("    ", hex(slot.base), ": ", slot.mappedPages, " pages\r\n");
+        ++count;
+        totalPages += slot.mappedPages;
+    }
+    dbgmsg("  ", count, " allocations, ", TO_KiB(totalPages * PAGE_SIZE),
+           "KiB mapped\r\n\r\n");
+}
+
 void heap_print_debug() {
     uint64_t heapSize = (uint64_t)(sHeapEnd) - (uint64_t)(sHeapStart);
 
-    dbgmsg(
-        "[Heap]: Debug information:\r\n"
-        "  Size:   %ull\r\n"
-        "  Start:  %x\r\n"
-        "  End:    %x\r\n"
-        "  Regions:\r\n",
-        heapSize, sHeapStart, sHeapEnd);
+    dbgmsg("[Heap]: Debug information:\r\n",
+           "  Size:   ", heapSize, "\r\n",
+           "  Start:  ", sHeapStart, "\r\n",
+           "  End:    ", sHeapEnd, "\r\n",
+           "  Regions:\r\n");
 
     uint64_t i = 0;
     uint64_t usedCount = 0;
@@ -292,15 +625,13 @@ void heap_print_debug() {
         float efficiency =
             (float)it->length / (float)(it->length + sizeof(HeapSegmentHeader));
 
-        dbgmsg(
-            "    Region %ull:\r\n"
-            "      Free:   %s\r\n"
-            "      Length: %ull (%ull) %%f\r\n"
-            "      Header Address:  %x\r\n"
-            "      Payload Address: %x\r\n",
-            i, to_string(it->free), it->length,
-            it->length + sizeof(HeapSegmentHeader), 100.0f * efficiency, it,
-            (uint64_t)(it) + sizeof(HeapSegmentHeader));
+        dbgmsg("    Region ", i, ":\r\n",
+               "      Free:   ", it->free, "\r\n",
+               "      Length: ", it->length, " (", it->length + sizeof(HeapSegmentHeader), ") ",
+               100.0f * efficiency, "%\r\n",
+               "      Header Address:  ", it, "\r\n",
+               "      Payload Address: ", hex((uint64_t)(it) + sizeof(HeapSegmentHeader)),
+               "\r\n");
 
         if (!it->free) {
             usedSpaceEfficiency += efficiency;
@@ -313,24 +644,21 @@ void heap_print_debug() {
 
     dbgmsg("\r\n");
 
-    dbgmsg(
-        "Heap Metadata vs Payload ratio in used regions (lower is better): "
-        "%%f\r\n\r\n",
-        100.0f * (1.0f - usedSpaceEfficiency / (float)usedCount));
+    dbgmsg("Heap Metadata vs Payload ratio in used regions (lower is better): ",
+           100.0f * (1.0f - usedSpaceEfficiency / (float)usedCount), "%\r\n\r\n");
 
+    heap_print_debug_large();
     heap_print_debug_starchart();
 }
 
 void heap_print_debug_summed() {
     uint64_t heapSize = (uint64_t)(sHeapEnd) - (uint64_t)(sHeapStart);
 
-    dbgmsg(
-        "[Heap]: Debug information:\r\n"
-        "  Size:   %ull\r\n"
-        "  Start:  %x\r\n"
-        "  End:    %x\r\n"
-        "  Regions:\r\n",
-        heapSize, sHeapStart, sHeapEnd);
+    dbgmsg("[Heap]: Debug information:\r\n",
+           "  Size:   ", heapSize, "\r\n",
+           "  Start:  ", sHeapStart, "\r\n",
+           "  End:    ", sHeapEnd, "\r\n",
+           "  Regions:\r\n");
 
     float usedSpaceEfficiency = 0.0f;
     uint64_t i = 0;
@@ -373,35 +701,86 @@ void heap_print_debug_summed() {
         }
 
         if (i - start_i == 1 || i - start_i == 0) {
-            dbgmsg("    Region %ull:\r\n", start_i);
+            dbgmsg("    Region ", start_i, ":\r\n");
         } else {
-            dbgmsg("    Region %ull through %ull:\r\n", start_i, i - 1);
+            dbgmsg("    Region ", start_i, " through ", i - 1, ":\r\n");
         }
 
         efficiency = efficiency / (i - start_i ? i - start_i : 1);
 
-        dbgmsg(
-            "      Free:          %s\r\n"
-            "      Length:        %ull (%ull) %%f\r\n"
-            "      Start Address: %x\r\n",
-            to_string(free), payload_total, total_length, 100.0f * efficiency,
-            start_it);
+        dbgmsg("      Free:          ", free, "\r\n",
+               "      Length:        ", payload_total, " (", total_length, ") ",
+               100.0f * efficiency, "%\r\n",
+               "      Start Address: ", start_it, "\r\n");
     };
 
     dbgmsg("\r\n");
-    dbgmsg(
-        "Heap Metadata vs Payload ratio in used regions (lower is better): "
-        "%%f\r\n\r\n",
-        100.0f * (1.0f - (usedSpaceEfficiency / (float)usedCount)));
+    dbgmsg("Heap Metadata vs Payload ratio in used regions (lower is better): ",
+           100.0f * (1.0f - (usedSpaceEfficiency / (float)usedCount)), "%\r\n\r\n");
 
+    heap_print_debug_large();
     heap_print_debug_starchart();
 }
 
+void heap_benchmark() {
+    constexpr uint64_t allocationCount = 512;
+    static void* allocations[allocationCount];
+
+    uint64_t start = CPU::rdtsc();
+    for (uint64_t i = 0; i < allocationCount; ++i)
+        allocations[i] = malloc(8 + ((i * 37) % 1024));
+
+    uint64_t allocated = CPU::rdtsc();
+    for (uint64_t i = 0; i < allocationCount; ++i)
+        free(allocations[i]);
+
+    uint64_t freed = CPU::rdtsc();
+    dbgmsg("[HEAP]: Benchmark of ", allocationCount, " allocations\r\n",
+           "  malloc(): ", allocated - start, " cycles (", (allocated - start) / allocationCount,
+           " per call)\r\n",
+           "  free():   ", freed - allocated, " cycles (", (freed - allocated) / allocationCount,
+           " per call)\r\n"
+           "\r\n");
+}
+
+void heap_benchmark_trim() {
+    constexpr uint64_t cycles = 64;
+    // Large enough to grow the heap past the trim threshold, small enough to stay in it.
+    constexpr uint64_t numBytes = HEAP_LARGE_ALLOCATION_THRESHOLD - KiB(4);
+
+    uint64_t expansions = sHeapExpansions;
+    uint64_t trims = sHeapTrims;
+    uint64_t start = CPU::rdtsc();
+    for (uint64_t i = 0; i < cycles; ++i)
+        free(malloc(numBytes));
+
+    uint64_t end = CPU::rdtsc();
+    dbgmsg("[HEAP]: ", cycles, " malloc()/free() pairs of ", numBytes, " bytes\r\n",
+           "  ", end - start, " cycles (", (end - start) / cycles, " per pair)\r\n",
+           "  Heap grew ", sHeapExpansions - expansions, " times and shrank ",
+           sHeapTrims - trims, " times\r\n"
+           "\r\n");
+}
+
+static void heap_benchmark_command(StringView arguments) {
+    uint64_t position = 0;
+    StringView which = Commands::next_word(arguments, position);
+
+    if (which.empty())
+        heap_benchmark();
+    else if (which == "trim")
+        heap_benchmark_trim();
+    else
+        dbgmsg("Usage: ", gHeapBenchmarkCommand.Usage, "\r\n");
+}
+
+const Command gHeapBenchmarkCommand{"heapbench", "heapbench [trim]", heap_benchmark_command};
+
 void* operator new(uint64_t numBytes) {
-    return malloc(numBytes);
+    return malloc_impl(numBytes, __builtin_return_address(0));
 }
 void* operator new[](uint64_t numBytes) {
-    return malloc(numBytes);
+    return malloc_impl(numBytes, __builtin_return_address(0));
 }
 void operator delete(void* address) noexcept {
     return free(address);
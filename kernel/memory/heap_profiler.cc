@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <debug.hpp>
+#include <kernel/commands.hpp>
+#include <memory/heap_profiler.hpp>
+#include <memory/memory.hpp>
+
+#ifdef HEAP_PROFILER
+
+struct HeapCallsite {
+    void* Callsite;
+    uint64_t Allocations;
+    uint64_t Frees;
+    uint64_t Bytes;
+    uint64_t LiveBytes;
+    uint64_t PeakLiveBytes;
+    uint64_t Cycles;
+};
+
+HeapCallsite sCallsites[HEAP_PROFILER_CALLSITES];
+uint64_t sCallsitesUsed{0};
+// Allocations whose callsite didn't fit in the table.
+uint64_t sUntrackedAllocations{0};
+
+/**
+ * @return the table entry for `callsite`, claiming an empty one if it
+ *      isn't in the table yet, or `nullptr` if the table is full.
+ */
+static HeapCallsite* find_callsite(void* callsite, bool insert) {
+    uint64_t index = (((uint64_t)callsite * 0x9e3779b97f4a7c15) >> 32) &
+                     (HEAP_PROFILER_CALLSITES - 1);
+
+    // Linear probing; the table never shrinks, so a gap ends the search.
+    for (uint64_t i = 0; i < HEAP_PROFILER_CALLSITES; ++i) {
+        HeapCallsite& entry =
+            sCallsites[(index + i) & (HEAP_PROFILER_CALLSITES - 1)];
+        if (entry.Callsite == callsite)
+            return &entry;
+
+        if (entry.Callsite == nullptr) {
+            if (!insert)
+                return nullptr;
+
+            entry.Callsite = callsite;
+            sCallsitesUsed++;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void heap_profiler_record_allocation(void* callsite, uint64_t numBytes,
+                                     uint64_t cycles) {
+    HeapCallsite* entry = find_callsite(callsite, true);
+    if (entry == nullptr) {
+        sUntrackedAllocations++;
+        return;
+    }
+
+    entry->Allocations++;
+    entry->Bytes += numBytes;
+    entry->Cycles += cycles;
+    entry->LiveBytes += numBytes;
+    if (entry->LiveBytes > entry->PeakLiveBytes)
+        entry->PeakLiveBytes = entry->LiveBytes;
+}
+
+void heap_profiler_record_free(void* callsite, uint64_t numBytes) {
+    HeapCallsite* entry = find_callsite(callsite, false);
+    if (entry == nullptr)
+        return;
+
+    entry->Frees++;
+    // Allocations made before a reset may be freed after it.
+    entry->LiveBytes = entry->LiveBytes > numBytes ? entry->LiveBytes - numBytes : 0;
+}
+
+void heap_profiler_reset() {
+    memset(sCallsites, 0, sizeof(sCallsites));
+    sCallsitesUsed = 0;
+    sUntrackedAllocations = 0;
+}
+
+void heap_profiler_dump(uint64_t count) {
+    // Sorted without touching the heap, as that would skew the results.
+    static uint16_t order[HEAP_PROFILER_CALLSITES];
+    uint64_t used = 0;
+
+    for (uint64_t i = 0; i < HEAP_PROFILER_CALLSITES; ++i) {
+        if (sCallsites[i].Callsite == nullptr)
+            continue;
+
+        // Insertion sort, descending by live bytes.
+        uint64_t j = used++;
+        while (j > 0 &&
+               sCallsites[order[j - 1]].LiveBytes < sCallsites[i].LiveBytes) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = i;
+    }
+
+    if (count > used)
+        count = used;
+
+    dbgmsg("[HEAP PROFILER]: Top ", count, " of ", used, " callsites by live bytes\r\n");
+    for (uint64_t i = 0; i < count; ++i) {
+        HeapCallsite& entry = sCallsites[order[i]];
+        dbgmsg("  ", entry.Callsite, ":\r\n",
+               "    Live: ", entry.LiveBytes, " bytes (peak ", entry.PeakLiveBytes,
+               " bytes)\r\n",
+               "    Allocations: ", entry.Allocations, " (", entry.Frees, " freed), ",
+               entry.Bytes, " bytes total\r\n",
+               "    Average cost: ", entry.Cycles / entry.Allocations, " cycles\r\n");
+    }
+    if (sUntrackedAllocations > 0) {
+        dbgmsg("  ", sUntrackedAllocations,
+               " allocations from callsites that didn't fit in the table\r\n");
+    }
+    dbgmsg_s("\r\n");
+}
+
+#else
+
+void heap_profiler_record_allocation(void*, uint64_t, uint64_t) {}
+void heap_profiler_record_free(void*, uint64_t) {}
+void heap_profiler_reset() {}
+
+void heap_profiler_dump(uint64_t) {
+    dbgmsg_s("[HEAP PROFILER]: Not enabled; configure with -DHEAP_PROFILER=ON\r\n");
+}
+
+#endif  // HEAP_PROFILER
+
+static void heap_profiler_command(StringView arguments) {
+    uint64_t position = 0;
+    StringView action = Commands::next_word(arguments, position);
+    uint64_t count = 10;
+
+    if (action == "reset")
+        heap_profiler_reset();
+    else if (action.empty() || Commands::parse_number(action, count))
+        heap_profiler_dump(count);
+    else
+        dbgmsg("Usage: ", gHeapProfilerCommand.Usage, "\r\n");
+}
+
+const Command gHeapProfilerCommand{"heapprof", "heapprof [count] | reset", heap_profiler_command};
@@ -1,17 +1,404 @@
+#include <arch/x86_64/cpu.hpp>
+#include <debug.hpp>
 #include <int.hpp>
+#include <kernel/commands.hpp>
+#include <memory/common.hpp>
 #include <memory/efi_memory.hpp>
 #include <memory/memory.hpp>
+#include <memory/physical_memory_manager.hpp>
 
-int memcmp(void* aptr, void* bptr, uint64_t numBytes) {
-    if (aptr == bptr)
-        return 0;
+/**
+ * Every routine comes in several variants: the simple byte-at-a-time
+ *  loops (kept as a baseline for `memory_benchmark()`), 64-bit loops,
+ *  `rep movsb`/`rep stosb` (fast on CPUs with ERMS/FSRM), SSE2 and AVX
+ *  loops that align the destination first, and SSE2 non-temporal
+ *  variants that bypass the cache for copies too large to stay in it.
+ *
+ * The public routines pick a variant by size: small ranges use the 64-bit
+ *  loops, huge copies and fills the non-temporal ones, and everything in
+ *  between goes through a function pointer that `memory_select_routines()`
+ *  binds to the best variant the CPU supports, once, at boot. Until then
+ *  they use SSE2, which every x86_64 CPU has (and UEFI firmware enables).
+ */
+
+// Unaligned, aliasing-safe view of memory.
+typedef uint64_t __attribute__((may_alias, aligned(1))) unaligned_u64;
+
+/// Copy routines
+
+static void memcpy_bytewise(const void* src, void* dest, uint64_t numBytes) {
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dest;
+
+    while (numBytes--)
+        *d++ = *s++;
+}
+
+static void memcpy_qword(const void* src, void* dest, uint64_t numBytes) {
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dest;
+
+    if (numBytes < 8) {
+        memcpy_bytewise(s, d, numBytes);
+        return;
+    }
+
+    // Copy the (possibly overlapping) last eight bytes up front, so the
+    //   loop below doesn't need a byte-sized tail.
+    *(unaligned_u64*)(d + numBytes - 8) = *(const unaligned_u64*)(s + numBytes - 8);
+
+    // Align the destination; the unaligned first qword covers the head.
+    *(unaligned_u64*)d = *(const unaligned_u64*)s;
+    uint64_t head = 8 - ((uint64_t)d & 7);
+    s += head;
+    d += head;
+    numBytes -= head;
+
+    while (numBytes >= 32) {
+        uint64_t a = ((const unaligned_u64*)s)[0];
+        uint64_t b = ((const unaligned_u64*)s)[1];
+        uint64_t c = ((const unaligned_u64*)s)[2];
+        uint64_t e = ((const unaligned_u64*)s)[3];
+        ((uint64_t*)d)[0] = a;
+        ((uint64_t*)d)[1] = b;
+        ((uint64_t*)d)[2] = c;
+        ((uint64_t*)d)[3] = e;
+        s += 32;
+        d += 32;
+        numBytes -= 32;
+    }
+    while (numBytes >= 8) {
+        *(uint64_t*)d = *(const unaligned_u64*)s;
+        s += 8;
+        d += 8;
+        numBytes -= 8;
+    }
+}
+
+static void memcpy_rep_movsb(const void* src, void* dest, uint64_t numBytes) {
+    asm volatile("rep movsb"
+                 : "+S"(src), "+D"(dest), "+c"(numBytes)
+                 :  // No inputs
+                 : "memory");
+}
+
+/**
+ * @brief Copy whole 64-byte blocks with SSE2; `dest` must be 16-byte
+ *      aligned. Non-temporal stores are used when `streaming` is set.
+ */
+static void copy_blocks_sse2(const uint8_t* src, uint8_t* dest, uint64_t blocks,
+                             bool streaming) {
+    if (blocks == 0)
+        return;
+
+    if (streaming) {
+        asm volatile(
+            "1:\n\t"
+            "movdqu (%[src]), %%xmm0\n\t"
+            "movdqu 16(%[src]), %%xmm1\n\t"
+            "movdqu 32(%[src]), %%xmm2\n\t"
+            "movdqu 48(%[src]), %%xmm3\n\t"
+            "movntdq %%xmm0, (%[dest])\n\t"
+            "movntdq %%xmm1, 16(%[dest])\n\t"
+            "movntdq %%xmm2, 32(%[dest])\n\t"
+            "movntdq %%xmm3, 48(%[dest])\n\t"
+            "add $64, %[src]\n\t"
+            "add $64, %[dest]\n\t"
+            "dec %[blocks]\n\t"
+            "jnz 1b\n\t"
+            // Non-temporal stores are weakly ordered.
+            "sfence"
+            : [src] "+r"(src), [dest] "+r"(dest), [blocks] "+r"(blocks)
+            :  // No other inputs
+            : "xmm0", "xmm1", "xmm2", "xmm3", "memory");
+    } else {
+        asm volatile(
+            "1:\n\t"
+            "movdqu (%[src]), %%xmm0\n\t"
+            "movdqu 16(%[src]), %%xmm1\n\t"
+            "movdqu 32(%[src]), %%xmm2\n\t"
+            "movdqu 48(%[src]), %%xmm3\n\t"
+            "movdqa %%xmm0, (%[dest])\n\t"
+            "movdqa %%xmm1, 16(%[dest])\n\t"
+            "movdqa %%xmm2, 32(%[dest])\n\t"
+            "movdqa %%xmm3, 48(%[dest])\n\t"
+            "add $64, %[src]\n\t"
+            "add $64, %[dest]\n\t"
+            "dec %[blocks]\n\t"
+            "jnz 1b"
+            : [src] "+r"(src), [dest] "+r"(dest), [blocks] "+r"(blocks)
+            :  // No other inputs
+            : "xmm0", "xmm1", "xmm2", "xmm3", "memory");
+    }
+}
+
+static void memcpy_simd(const void* src, void* dest, uint64_t numBytes,
+                        uint64_t alignment, bool avx, bool streaming) {
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dest;
+
+    // Align the destination so every vector store is aligned.
+    uint64_t head = (0 - (uint64_t)d) & (alignment - 1);
+    if (head > numBytes)
+        head = numBytes;
+    memcpy_qword(s, d, head);
+    s += head;
+    d += head;
+    numBytes -= head;
+
+    uint64_t blocks = numBytes / 64;
+    if (avx && blocks) {
+        asm volatile(
+            "1:\n\t"
+            "vmovdqu (%[src]), %%ymm0\n\t"
+            "vmovdqu 32(%[src]), %%ymm1\n\t"
+            "vmovdqa %%ymm0, (%[dest])\n\t"
+            "vmovdqa %%ymm1, 32(%[dest])\n\t"
+            "add $64, %[src]\n\t"
+            "add $64, %[dest]\n\t"
+            "dec %[blocks]\n\t"
+            "jnz 1b\n\t"
+            // Avoid SSE/AVX transition penalties in the code that follows.
+            "vzeroupper"
+            : [src] "+r"(s), [dest] "+r"(d), [blocks] "+r"(blocks)
+            :  // No other inputs
+            : "xmm0", "xmm1", "memory");
+    } else {
+        copy_blocks_sse2(s, d, blocks, streaming);
+        s += blocks * 64;
+        d += blocks * 64;
+    }
+
+    memcpy_qword(s, d, numBytes % 64);
+}
+
+static void memcpy_sse2(const void* src, void* dest, uint64_t numBytes) {
+    memcpy_simd(src, dest, numBytes, 16, false, false);
+}
+
+static void memcpy_avx(const void* src, void* dest, uint64_t numBytes) {
+    memcpy_simd(src, dest, numBytes, 32, true, false);
+}
 
+static void memcpy_nontemporal(const void* src, void* dest, uint64_t numBytes) {
+    memcpy_simd(src, dest, numBytes, 16, false, true);
+}
+
+// Variant used for copies between the SIMD and non-temporal thresholds.
+static void (*sMemcpyMedium)(const void*, void*, uint64_t){memcpy_sse2};
+
+void memcpy(const void* src, void* dest, uint64_t numBytes) {
+    if (src == nullptr || dest == nullptr)
+        return;
+
+    if (numBytes < MEMORY_SIMD_THRESHOLD)
+        memcpy_qword(src, dest, numBytes);
+    else if (numBytes < MEMORY_NONTEMPORAL_THRESHOLD)
+        sMemcpyMedium(src, dest, numBytes);
+    else
+        memcpy_nontemporal(src, dest, numBytes);
+}
+
+// Copy from the start of the range towards the end, one qword at a time.
+static void memcpy_forward(const void* src, void* dest, uint64_t numBytes) {
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dest;
+
+    while (numBytes >= 8) {
+        *(unaligned_u64*)d = *(const unaligned_u64*)s;
+        s += 8;
+        d += 8;
+        numBytes -= 8;
+    }
+    while (numBytes--)
+        *d++ = *s++;
+}
+
+// Copy from the end of the range towards the start, one qword at a time.
+static void memcpy_backward(const void* src, void* dest, uint64_t numBytes) {
+    const uint8_t* s = (const uint8_t*)src + numBytes;
+    uint8_t* d = (uint8_t*)dest + numBytes;
+
+    while (numBytes >= 8) {
+        s -= 8;
+        d -= 8;
+        numBytes -= 8;
+        *(unaligned_u64*)d = *(const unaligned_u64*)s;
+    }
+    while (numBytes--)
+        *--d = *--s;
+}
+
+void memmove(const void* src, void* dest, uint64_t numBytes) {
+    if (src == nullptr || dest == nullptr || src == dest)
+        return;
+
+    uint64_t s = (uint64_t)src;
+    uint64_t d = (uint64_t)dest;
+
+    if (d + numBytes <= s || s + numBytes <= d) {
+        memcpy(src, dest, numBytes);
+        return;
+    }
+
+    /**
+     * The ranges overlap. Each qword is read before it is written, so
+     *  copying away from the overlap never clobbers unread source bytes:
+     *  forwards when `dest` is below `src`, backwards otherwise.
+     */
+    if (d < s)
+        memcpy_forward(src, dest, numBytes);
+    else
+        memcpy_backward(src, dest, numBytes);
+}
+
+/// Fill routines
+
+static void memset_bytewise(void* start, uint8_t value, uint64_t numBytes) {
+    uint8_t* d = (uint8_t*)start;
+
+    while (numBytes--)
+        *d++ = value;
+}
+
+static void memset_qword(void* start, uint8_t value, uint64_t numBytes) {
+    uint8_t* d = (uint8_t*)start;
+    uint64_t pattern = value * 0x0101010101010101ull;
+
+    if (numBytes < 8) {
+        memset_bytewise(d, value, numBytes);
+        return;
+    }
+
+    // Unaligned stores cover the head and tail.
+    *(unaligned_u64*)d = pattern;
+    *(unaligned_u64*)(d + numBytes - 8) = pattern;
+
+    uint64_t head = 8 - ((uint64_t)d & 7);
+    d += head;
+    numBytes -= head;
+
+    while (numBytes >= 32) {
+        ((uint64_t*)d)[0] = pattern;
+        ((uint64_t*)d)[1] = pattern;
+        ((uint64_t*)d)[2] = pattern;
+        ((uint64_t*)d)[3] = pattern;
+        d += 32;
+        numBytes -= 32;
+    }
+    while (numBytes >= 8) {
+        *(uint64_t*)d = pattern;
+        d += 8;
+        numBytes -= 8;
+    }
+}
+
+static void memset_rep_stosb(void* start, uint8_t value, uint64_t numBytes) {
+    asm volatile("rep stosb"
+                 : "+D"(start), "+c"(numBytes)
+                 : "a"(value)
+                 : "memory");
+}
+
+static void memset_simd(void* start, uint8_t value, uint64_t numBytes,
+                        uint64_t alignment, bool avx, bool streaming) {
+    uint8_t* d = (uint8_t*)start;
+    uint64_t pattern = value * 0x0101010101010101ull;
+
+    uint64_t head = (0 - (uint64_t)d) & (alignment - 1);
+    if (head > numBytes)
+        head = numBytes;
+    memset_qword(d, value, head);
+    d += head;
+    numBytes -= head;
+
+    uint64_t blocks = numBytes / 64;
+    if (blocks) {
+        if (avx) {
+            asm volatile(
+                "vmovq %[pattern], %%xmm0\n\t"
+                "vpunpcklqdq %%xmm0, %%xmm0, %%xmm0\n\t"
+                "vinsertf128 $1, %%xmm0, %%ymm0, %%ymm0\n\t"
+                "1:\n\t"
+                "vmovdqa %%ymm0, (%[dest])\n\t"
+                "vmovdqa %%ymm0, 32(%[dest])\n\t"
+                "add $64, %[dest]\n\t"
+                "dec %[blocks]\n\t"
+                "jnz 1b\n\t"
+                "vzeroupper"
+                : [dest] "+r"(d), [blocks] "+r"(blocks)
+                : [pattern] "r"(pattern)
+                : "xmm0", "memory");
+        } else if (streaming) {
+            asm volatile(
+                "movq %[pattern], %%xmm0\n\t"
+                "punpcklqdq %%xmm0, %%xmm0\n\t"
+                "1:\n\t"
+                "movntdq %%xmm0, (%[dest])\n\t"
+                "movntdq %%xmm0, 16(%[dest])\n\t"
+                "movntdq %%xmm0, 32(%[dest])\n\t"
+                "movntdq %%xmm0, 48(%[dest])\n\t"
+                "add $64, %[dest]\n\t"
+                "dec %[blocks]\n\t"
+                "jnz 1b\n\t"
+                "sfence"
+                : [dest] "+r"(d), [blocks] "+r"(blocks)
+                : [pattern] "r"(pattern)
+                : "xmm0", "memory");
+        } else {
+            asm volatile(
+                "movq %[pattern], %%xmm0\n\t"
+                "punpcklqdq %%xmm0, %%xmm0\n\t"
+                "1:\n\t"
+                "movdqa %%xmm0, (%[dest])\n\t"
+                "movdqa %%xmm0, 16(%[dest])\n\t"
+                "movdqa %%xmm0, 32(%[dest])\n\t"
+                "movdqa %%xmm0, 48(%[dest])\n\t"
+                "add $64, %[dest]\n\t"
+                "dec %[blocks]\n\t"
+                "jnz 1b"
+                : [dest] "+r"(d), [blocks] "+r"(blocks)
+                : [pattern] "r"(pattern)
+                : "xmm0", "memory");
+        }
+    }
+
+    memset_qword(d, value, numBytes % 64);
+}
+
+static void memset_sse2(void* start, uint8_t value, uint64_t numBytes) {
+    memset_simd(start, value, numBytes, 16, false, false);
+}
+
+static void memset_avx(void* start, uint8_t value, uint64_t numBytes) {
+    memset_simd(start, value, numBytes, 32, true, false);
+}
+
+static void memset_nontemporal(void* start, uint8_t value, uint64_t numBytes) {
+    memset_simd(start, value, numBytes, 16, false, true);
+}
+
+// Variant used for fills between the SIMD and non-temporal thresholds.
+static void (*sMemsetMedium)(void*, uint8_t, uint64_t){memset_sse2};
+
+void memset(void* start, uint8_t value, uint64_t numBytes) {
+    if (numBytes < MEMORY_SIMD_THRESHOLD)
+        memset_qword(start, value, numBytes);
+    else if (numBytes < MEMORY_NONTEMPORAL_THRESHOLD)
+        sMemsetMedium(start, value, numBytes);
+    else
+        memset_nontemporal(start, value, numBytes);
+}
+
+/// Compare routines
+
+static int memcmp_bytewise(void* aptr, void* bptr, uint64_t numBytes) {
     uint8_t* a = (uint8_t*)aptr;
     uint8_t* b = (uint8_t*)bptr;
 
     while (numBytes--) {
         if (*a != *b)
-            return 1;
+            return *a - *b;
         a++;
         b++;
     }
@@ -19,42 +406,185 @@ int memcmp(void* aptr, void* bptr, uint64_t numBytes) {
     return 0;
 }
 
-void memcpy(const void* src, void* dest, uint64_t numBytes) {
-    char* pszDest = (char*)dest;
-    const char* pszSource = (const char*)src;
-
-    if((pszDest != NULL) && (pszSource != NULL)) {
-        while(numBytes) {
-            // Copy byte by byte
-            *(pszDest++) = *(pszSource++);
-            --numBytes;
+static int memcmp_qword(void* aptr, void* bptr, uint64_t numBytes) {
+    uint8_t* a = (uint8_t*)aptr;
+    uint8_t* b = (uint8_t*)bptr;
+
+    while (numBytes >= 8) {
+        uint64_t x = *(unaligned_u64*)a;
+        uint64_t y = *(unaligned_u64*)b;
+        if (x != y) {
+            // Little endian: the lowest differing bit is in the first differing byte.
+            uint64_t index = __builtin_ctzll(x ^ y) / 8;
+            return a[index] - b[index];
         }
+        a += 8;
+        b += 8;
+        numBytes -= 8;
     }
+
+    return memcmp_bytewise(a, b, numBytes);
 }
 
-void memset(void* start, uint8_t value, uint64_t numBytes) {
-    if (numBytes >= 256) {
-        uint64_t qWordValue = 0;
-
-        qWordValue |= (uint64_t)value << 0;
-        qWordValue |= (uint64_t)value << 8;
-        qWordValue |= (uint64_t)value << 16;
-        qWordValue |= (uint64_t)value << 24;
-        qWordValue |= (uint64_t)value << 32;
-        qWordValue |= (uint64_t)value << 40;
-        qWordValue |= (uint64_t)value << 48;
-        qWordValue |= (uint64_t)value << 56;
-
-        for (uint64_t i = 0; i <= numBytes - 8; i += 8) {
-            *(uint64_t*)((uint64_t)start + i) = qWordValue;
+static int memcmp_sse2(void* aptr, void* bptr, uint64_t numBytes) {
+    uint8_t* a = (uint8_t*)aptr;
+    uint8_t* b = (uint8_t*)bptr;
+
+    while (numBytes >= 16) {
+        uint32_t equalMask;
+        asm volatile(
+            "movdqu (%[a]), %%xmm0\n\t"
+            "movdqu (%[b]), %%xmm1\n\t"
+            "pcmpeqb %%xmm1, %%xmm0\n\t"
+            "pmovmskb %%xmm0, %[mask]"
+            : [mask] "=r"(equalMask)
+            : [a] "r"(a), [b] "r"(b)
+            : "xmm0", "xmm1", "memory");
+
+        if (equalMask != 0xffff) {
+            uint64_t index = __builtin_ctz(~equalMask);
+            return a[index] - b[index];
         }
+        a += 16;
+        b += 16;
+        numBytes -= 16;
     }
 
-    for (uint64_t i = 0; i < numBytes; ++i) {
-        *(uint8_t*)((uint64_t)start + i) = value;
+    return memcmp_qword(a, b, numBytes);
+}
+
+int memcmp(void* aptr, void* bptr, uint64_t numBytes) {
+    if (aptr == bptr)
+        return 0;
+
+    if (numBytes < MEMORY_SIMD_THRESHOLD)
+        return memcmp_qword(aptr, bptr, numBytes);
+
+    return memcmp_sse2(aptr, bptr, numBytes);
+}
+
+/// Selection
+
+void memory_select_routines() {
+    const CPU::Features& features = CPU::features();
+
+    // Microcoded string moves beat hand-written loops on ERMS hardware.
+    if (features.ERMS) {
+        sMemcpyMedium = memcpy_rep_movsb;
+        sMemsetMedium = memset_rep_stosb;
+    } else if (features.AVXUsable) {
+        sMemcpyMedium = memcpy_avx;
+        sMemsetMedium = memset_avx;
+    } else {
+        sMemcpyMedium = memcpy_sse2;
+        sMemsetMedium = memset_sse2;
+    }
+}
+
+/// Benchmark
+
+struct CopyVariant {
+    const char* Name;
+    void (*Function)(const void*, void*, uint64_t);
+};
+
+struct FillVariant {
+    const char* Name;
+    void (*Function)(void*, uint8_t, uint64_t);
+};
+
+struct CompareVariant {
+    const char* Name;
+    int (*Function)(void*, void*, uint64_t);
+};
+
+// AVX variants come last, so they can be skipped when AVX isn't usable.
+static const CopyVariant sCopyVariants[] = {
+    {"bytewise", memcpy_bytewise},   {"qword", memcpy_qword},
+    {"rep movsb", memcpy_rep_movsb}, {"sse2", memcpy_sse2},
+    {"sse2 nt", memcpy_nontemporal}, {"avx", memcpy_avx},
+};
+static const FillVariant sFillVariants[] = {
+    {"bytewise", memset_bytewise},   {"qword", memset_qword},
+    {"rep stosb", memset_rep_stosb}, {"sse2", memset_sse2},
+    {"sse2 nt", memset_nontemporal}, {"avx", memset_avx},
+};
+static const CompareVariant sCompareVariants[] = {
+    {"bytewise", memcmp_bytewise},
+    {"qword", memcmp_qword},
+    {"sse2", memcmp_sse2},
+};
+
+void memory_benchmark() {
+    constexpr uint64_t bufferPages = MiB(4) / PAGE_SIZE;
+    constexpr uint64_t sizes[] = {16, 64, 256, KiB(4), KiB(64), MiB(1), MiB(4)};
+    // Roughly how many bytes each measurement moves in total.
+    constexpr uint64_t bytesPerMeasurement = MiB(16);
+
+    auto* a = (uint8_t*)Memory::request_pages(bufferPages);
+    auto* b = (uint8_t*)Memory::request_pages(bufferPages);
+    if (a == nullptr || b == nullptr) {
+        dbgmsg_s("[memory_benchmark]: \033[31mERROR\033[0m:: Could not allocate buffers\r\n");
+        if (a)
+            Memory::free_pages(a, bufferPages);
+        if (b)
+            Memory::free_pages(b, bufferPages);
+        return;
+    }
+
+    memset_qword(a, 0x5a, MiB(4));
+    memset_qword(b, 0x5a, MiB(4));
+
+    dbgmsg_s("[memory_benchmark]: Cycles per KiB (lower is better)\r\n");
+    for (uint64_t size : sizes) {
+        uint64_t iterations = bytesPerMeasurement / size;
+        // Offset by one byte to exercise the unaligned head/tail handling.
+        uint64_t offset = size < MiB(4) ? 1 : 0;
+
+        dbgmsg("  ", size, " bytes:\r\n");
+        for (const CopyVariant& variant : sCopyVariants) {
+            if (variant.Function == memcpy_avx && !CPU::features().AVXUsable)
+                continue;
+
+            uint64_t start = CPU::rdtsc();
+            for (uint64_t i = 0; i < iterations; ++i)
+                variant.Function(a + offset, b, size);
+            uint64_t cycles = CPU::rdtsc() - start;
+            dbgmsg("    memcpy ", variant.Name, ": ", cycles / TO_KiB(bytesPerMeasurement),
+                   "\r\n");
+        }
+        for (const FillVariant& variant : sFillVariants) {
+            if (variant.Function == memset_avx && !CPU::features().AVXUsable)
+                continue;
+
+            uint64_t start = CPU::rdtsc();
+            for (uint64_t i = 0; i < iterations; ++i)
+                variant.Function(b + offset, 0x5a, size - offset);
+            uint64_t cycles = CPU::rdtsc() - start;
+            dbgmsg("    memset ", variant.Name, ": ", cycles / TO_KiB(bytesPerMeasurement),
+                   "\r\n");
+        }
+        for (const CompareVariant& variant : sCompareVariants) {
+            uint64_t start = CPU::rdtsc();
+            for (uint64_t i = 0; i < iterations; ++i)
+                variant.Function(a + offset, b, size - offset);
+            uint64_t cycles = CPU::rdtsc() - start;
+            dbgmsg("    memcmp ", variant.Name, ": ", cycles / TO_KiB(bytesPerMeasurement),
+                   "\r\n");
+        }
     }
+    dbgmsg_s("\r\n");
+
+    Memory::free_pages(a, bufferPages);
+    Memory::free_pages(b, bufferPages);
 }
 
+static void memory_benchmark_command(StringView) {
+    memory_benchmark();
+}
+
+const Command gMemoryBenchmarkCommand{"membench", "membench", memory_benchmark_command};
+
 // void volatile_read(const volatile void* ptr, volatile void* out,
 //                    uint64_t length) {
 //     if (ptr == nullptr || out == nullptr || length == 0)
@@ -88,4 +618,4 @@ void memset(void* start, uint8_t value, uint64_t numBytes) {
 //     } else {
 //         memcpy(data, (void*)ptr, length);
 //     }
-// }
\ No newline at end of file
+// }
@@ -3,14 +3,14 @@
 #include <cstr.hpp>
 #include <debug.hpp>
 #include <link_definitions.hpp>
+#include <log/log.hpp>
 #include <memory/common.hpp>
 #include <memory/efi_memory.hpp>
 #include <memory/paging.hpp>
 #include <memory/physical_memory_manager.hpp>
 #include <memory/virtual_memory_manager.hpp>
 #include <panic/panic.hpp>
-// Uncomment the following directive for extra debug information output.
-//#define DEBUG_PMM
+#include <trace/trace.hpp>
 
 namespace Memory {
     Bitmap PageMap;
@@ -19,6 +19,8 @@ namespace Memory {
     uint64_t TotalFreePages { 0 };
     uint64_t TotalUsedPages { 0 };
     uint64_t MaxFreePagesInARow { 0 };
+    // Index of the lowest page that may be free; pages below it are all locked.
+    uint64_t FirstFreePage { 0 };
 
     uint64_t total_ram() {
         return TotalPages * PAGE_SIZE;
@@ -55,50 +57,39 @@ namespace Memory {
         if (PageMap.set(index, false)) {
             TotalUsedPages -= 1;
             TotalFreePages += 1;
+            // Make sure `request_page()` can find the page again.
+            if (index < FirstFreePage)
+                FirstFreePage = index;
         }
     }
 
     void free_pages(void* address, uint64_t numberOfPages) {
-#ifdef DEBUG_PMM
-        dbgmsg("free_pages():\r\n"
-               "  Address:     %x\r\n"
-               "  # of pages:  %ull\r\n"
-               "  Free before: %ull\r\n"
-               , address
-               , numberOfPages
-               , TotalFreePages);
-#endif
+        LOG(PMM, Trace, "free_pages():\r\n"
+                        "  Address:     ", address, "\r\n"
+                        "  # of pages:  ", numberOfPages, "\r\n"
+                        "  Free before: ", TotalFreePages, "\r\n");
         for (uint64_t i = 0; i < numberOfPages; ++i)
             free_page((void*)((uint64_t)address + (i * PAGE_SIZE)));
 
-#ifdef DEBUG_PMM
-        dbgmsg("  Free after: %ull\r\n"
-               "\r\n"
-               , TotalFreePages);
-#endif /* defined DEBUG_PMM */
+        LOG(PMM, Trace, "  Free after: ", TotalFreePages, "\r\n"
+                        "\r\n");
     }
 
-    uint64_t FirstFreePage { 0 };
     void* request_page() {
-#ifdef DEBUG_PMM
-        dbgmsg("request_page():\r\n"
-               "  Free pages:            %ull\r\n"
-               "  Max run of free pages: %ull\r\n"
-               "\r\n"
-               , TotalFreePages
-               , MaxFreePagesInARow);
-#endif
-        for(; FirstFreePage < TotalPages; FirstFreePage++) {
-            if (PageMap.get(FirstFreePage) == false) {
-                void* addr = (void*)(FirstFreePage * PAGE_SIZE);
-                lock_page(addr);
-                FirstFreePage += 1; // Eat current page.
-#ifdef DEBUG_PMM
-                dbgmsg("  Successfully fulfilled memory request: %x\r\n"
-                       "\r\n", addr);
-#endif
-                return addr;
-            }
+        TRACE_BEGIN(RequestPage, 0, 0);
+        LOG(PMM, Trace, "request_page():\r\n"
+                        "  Free pages:            ", TotalFreePages, "\r\n"
+                        "  Max run of free pages: ", MaxFreePagesInARow, "\r\n"
+                        "\r\n");
+        FirstFreePage = PageMap.find(false, FirstFreePage);
+        if (FirstFreePage < TotalPages) {
+            void* addr = (void*)(FirstFreePage * PAGE_SIZE);
+            lock_page(addr);
+            FirstFreePage += 1; // Eat current page.
+            LOG(PMM, Trace, "  Successfully fulfilled memory request: ", addr, "\r\n"
+                            "\r\n");
+            TRACE_END(RequestPage, addr, 0);
+            return addr;
         }
         // TODO: Page swap from/to file on disk.
         panic("\033[31mRan out of memory in request_page() :^<\033[0m\r\n");
@@ -114,61 +105,41 @@ namespace Memory {
             return request_page();
         // Can't allocate something larger than the amount of free memory.
         if (numberOfPages > TotalFreePages) {
-            dbgmsg("request_pages(): \033[31mERROR\033[0m:: "
-                   "Number of pages requested is larger than amount of pages available.");
+            LOG(PMM, Debug, "request_pages(): "
+                            "Number of pages requested is larger than amount of pages available.\r\n");
             return nullptr;
         }
         if (numberOfPages > MaxFreePagesInARow) {
-            dbgmsg("request_pages(): \033[31mERROR\033[0m:: "
-                   "Number of pages requested is larger than any contiguous run of pages available."
-                   );
+            LOG(PMM, Debug, "request_pages(): "
+                            "Number of pages requested is larger than any contiguous run of pages available.\r\n");
             return nullptr;
         }
         
-#ifdef DEBUG_PMM
-        dbgmsg("request_pages():\r\n"
-               "  # of pages requested:  %ull\r\n"
-               "  Free pages:            %ull\r\n"
-               "  Max run of free pages: %ull\r\n"
-               "\r\n"
-               , numberOfPages
-               , TotalFreePages
-               , MaxFreePagesInARow);
-#endif
+        LOG(PMM, Trace, "request_pages():\r\n"
+                        "  # of pages requested:  ", numberOfPages, "\r\n"
+                        "  Free pages:            ", TotalFreePages, "\r\n"
+                        "  Max run of free pages: ", MaxFreePagesInARow, "\r\n"
+                        "\r\n");
 
-        for (uint64_t i = FirstFreePage; i < PageMap.length(); ++i) {
-            // Skip locked pages.
-            if (PageMap[i] == true)
-                continue;
+        // Hop from the start of each run of free pages to its end.
+        for (uint64_t i = PageMap.find(false, FirstFreePage); i < TotalPages;
+             i = PageMap.find(false, i)) {
+            uint64_t end = PageMap.find(true, i);
+            if (end > TotalPages)
+                end = TotalPages;
 
-            // If page is free, check if entire `numberOfPages` run is free.
-            uint64_t index = i;
-            uint64_t run = 0;
-
-            while (PageMap[index] == false) {
-                run++;
-                index++;
-
-                if (index >= PageMap.length()) {
-                    // TODO: No memory matching criteria, should
-                    //   probably do a page swap from disk or something.
-                    panic("\033[0mRan out of memory in request_pages() :^<\033[0m\r\n");
-                    return nullptr;
-                }
-                if (run >= numberOfPages) {
-                    void* out = (void*)(i * PAGE_SIZE);
-                    lock_pages(out, numberOfPages);
-#ifdef DEBUG_PMM
-                    dbgmsg("  Successfully fulfilled memory request: %x\r\n"
-                           "\r\n", out);
-#endif
-                    return out;
-                }
+            if (end - i >= numberOfPages) {
+                void* out = (void*)(i * PAGE_SIZE);
+                lock_pages(out, numberOfPages);
+                LOG(PMM, Trace, "  Successfully fulfilled memory request: ", out, "\r\n"
+                                "\r\n");
+                return out;
             }
-            // If this point is reached, it means run was not long enough.
-            // Start searching for next run after the run we've already determined is not long enough.
-            i = index;
+            // The run was not long enough; carry on after it.
+            i = end;
         }
+        // TODO: No memory matching criteria, should
+        //   probably do a page swap from disk or something.
         return nullptr;
     }
 
@@ -178,11 +149,9 @@ namespace Memory {
     uint8_t InitialPageBitmap[InitialPageBitmapSize];
 
     void init_physical(EFI_MEMORY_DESCRIPTOR* memMap, uint64_t size, uint64_t entrySize) {
-#ifdef DEBUG_PMM
-        dbgmsg("Attempting to initialize physical memory\r\n"
-               "Searching for largest free contiguous memory region under %x\r\n"
-               , InitialPageBitmapMaxAddress);
-#endif /* defined DEBUG_PMM */
+        LOG(PMM, Debug, "Attempting to initialize physical memory\r\n"
+                        "Searching for largest free contiguous memory region under "
+                        , hex(InitialPageBitmapMaxAddress), "\r\n");
         // Calculate number of entries within memoryMap array.
         uint64_t entries = size / entrySize;
         // Find largest free and usable contiguous region of memory
@@ -204,19 +173,16 @@ namespace Memory {
         if (largestFreeMemorySegment == nullptr
             || largestFreeMemorySegmentPageCount == 0)
         {
-            dbgmsg("\033[31mERROR:\033[0m "
-                   "Could not find free memory segment during "
-                   "physical memory manager intialization."
-                   );
+            LOG(PMM, Error, "\033[31mERROR:\033[0m "
+                            "Could not find free memory segment during "
+                            "physical memory manager intialization.\r\n");
             while (true)
                 asm ("hlt");
         }
-#ifdef DEBUG_PMM
-        dbgmsg("Found initial free memory segment (%ullKiB) at %x\r\n"
-               , TO_KiB(largestFreeMemorySegmentPageCount * PAGE_SIZE)
-               , largestFreeMemorySegment
-               );
-#endif /* defined DEBUG_PMM */
+        LOG(PMM, Debug, "Found initial free memory segment ("
+                        , TO_KiB(largestFreeMemorySegmentPageCount * PAGE_SIZE)
+                        , "KiB) at ", largestFreeMemorySegment, "\r\n"
+                        );
         // Use pre-allocated memory region for initial physical page bitmap.
         PageMap.init(InitialPageBitmapSize, (uint8_t*)&InitialPageBitmap[0]);
         // Lock all pages in initial bitmap.
@@ -294,55 +260,39 @@ namespace Memory {
         dbgmsg("\033[32m"
                "Physical memory initialized"
                "\033[0m\r\n"
-               "  Physical memory mapped from %x thru %x\r\n"
-               "  Kernel loaded at %x (%ullMiB)\r\n"
-               "  Kernel mapped from %x thru %x (%ullKiB)\r\n"
-               "    .text:   %x thru %x (%ull bytes)\r\n"
-               "    .data:   %x thru %x (%ull bytes)\r\n"
-               "    .rodata: %x thru %x (%ull bytes)\r\n"
-               "    .bss:    %x thru %x (%ull bytes)\r\n"
-               "    Lost to page alignment: %ull bytes\r\n"
+               "  Physical memory mapped from ", hex(0), " thru ", hex(total_ram()), "\r\n"
+               "  Kernel loaded at ", &KERNEL_PHYSICAL
+               , " (", TO_MiB(&KERNEL_PHYSICAL), "MiB)\r\n"
+               "  Kernel mapped from ", &KERNEL_START, " thru ", &KERNEL_END
+               , " (", TO_KiB(kernelSize), "KiB)\r\n"
+               "    .text:   ", &TEXT_START, " thru ", &TEXT_END
+               , " (", textSize, " bytes)\r\n"
+               "    .data:   ", &DATA_START, " thru ", &DATA_END
+               , " (", dataSize, " bytes)\r\n"
+               "    .rodata: ", &READ_ONLY_DATA_START, " thru ", &READ_ONLY_DATA_END
+               , " (", rodataSize, " bytes)\r\n"
+               "    .bss:    ", &BLOCK_STARTING_SYMBOLS_START, " thru ", &BLOCK_STARTING_SYMBOLS_END
+               , " (", bssSize, " bytes)\r\n"
+               "    Lost to page alignment: ", deadSpace, " bytes\r\n"
                "\r\n"
-               , 0ULL, total_ram()
-               , &KERNEL_PHYSICAL
-               , TO_MiB(&KERNEL_PHYSICAL)
-               , &KERNEL_START, &KERNEL_END
-               , TO_KiB(kernelSize)
-               , &TEXT_START, &TEXT_END
-               , textSize
-               , &DATA_START, &DATA_END
-               , dataSize
-               , &READ_ONLY_DATA_START
-               , &READ_ONLY_DATA_END
-               , rodataSize
-               , &BLOCK_STARTING_SYMBOLS_START
-               , &BLOCK_STARTING_SYMBOLS_END
-               , bssSize
-               , deadSpace
                );
     }
 
     void print_debug_kib() {
         dbgmsg("Memory Manager Debug Information:\r\n"
-               "  Total Memory: %ullKiB\r\n"
-               "  Free Memory: %ullKiB\r\n"
-               "  Used Memory: %ullKiB\r\n"
+               "  Total Memory: ", TO_KiB(total_ram()), "KiB\r\n"
+               "  Free Memory: ", TO_KiB(free_ram()), "KiB\r\n"
+               "  Used Memory: ", TO_KiB(used_ram()), "KiB\r\n"
                "\r\n"
-               , TO_KiB(total_ram())
-               , TO_KiB(free_ram())
-               , TO_KiB(used_ram())
                );
     }
 
     void print_debug_mib() {
         dbgmsg("Memory Manager Debug Information:\r\n"
-               "  Total Memory: %ullMiB\r\n"
-               "  Free Memory: %ullMiB\r\n"
-               "  Used Memory: %ullMiB\r\n"
+               "  Total Memory: ", TO_MiB(total_ram()), "MiB\r\n"
+               "  Free Memory: ", TO_MiB(free_ram()), "MiB\r\n"
+               "  Used Memory: ", TO_MiB(used_ram()), "MiB\r\n"
                "\r\n"
-               , TO_MiB(total_ram())
-               , TO_MiB(free_ram())
-               , TO_MiB(used_ram())
                );
     }
 
@@ -3,147 +3,152 @@
 #include <cstdint>
 #include <debug.hpp>
 #include <link_definitions.hpp>
+#include <log/log.hpp>
 #include <memory/common.hpp>
 #include <memory/memory.hpp>
 #include <memory/paging.hpp>
 #include <memory/physical_memory_manager.hpp>
 #include <memory/virtual_memory_manager.hpp>
+#include <trace/trace.hpp>
 namespace Memory {
 PageTable* ActivePageMap;
 
-void map(PageTable* pageMapLevelFour, void* virtualAddress,
-         void* physicalAddress, uint64_t mappingFlags, ShowDebug debug) {
+// Apply the given mapping flags to a page table entry (the last level).
+static void apply_flags(PageDirectoryEntry& PDE, uint64_t mappingFlags) {
+    PDE.set_flag(PageTableFlag::Present,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::Present));
+    PDE.set_flag(PageTableFlag::ReadWrite,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::ReadWrite));
+    PDE.set_flag(PageTableFlag::UserSuper,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::UserSuper));
+    PDE.set_flag(
+        PageTableFlag::WriteThrough,
+        mappingFlags & static_cast<uint64_t>(PageTableFlag::WriteThrough));
+    PDE.set_flag(
+        PageTableFlag::CacheDisabled,
+        mappingFlags & static_cast<uint64_t>(PageTableFlag::CacheDisabled));
+    PDE.set_flag(PageTableFlag::Accessed,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::Accessed));
+    PDE.set_flag(PageTableFlag::Dirty,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::Dirty));
+    PDE.set_flag(
+        PageTableFlag::LargerPages,
+        mappingFlags & static_cast<uint64_t>(PageTableFlag::LargerPages));
+    PDE.set_flag(PageTableFlag::Global,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::Global));
+    PDE.set_flag(PageTableFlag::NX,
+                 mappingFlags & static_cast<uint64_t>(PageTableFlag::NX));
+}
+
+/**
+ * @return the table that `table->entries[index]` points to, allocating
+ *      (and zeroing) it first if the entry is not yet present.
+ *
+ * @note An upper-level entry covers every mapping beneath it, and the
+ *      effective permissions are the most restrictive along the walk.
+ *      So it only ever gains Present, ReadWrite and UserSuper from
+ *      `mappingFlags`; NX, Global and the rest stay with the leaf.
+ */
+static PageTable* next_level(PageTable* table, uint64_t index,
+                             uint64_t mappingFlags) {
+    PageDirectoryEntry PDE = table->entries[index];
+    if (!PDE.flag(PageTableFlag::Present)) {
+        PageTable* next = (PageTable*)request_page();
+        memset(next, 0, PAGE_SIZE);
+        PDE.set_address((uint64_t)next >> 12);
+    }
+    PDE.set_flag(PageTableFlag::Present, true);
+    if (mappingFlags & static_cast<uint64_t>(PageTableFlag::ReadWrite))
+        PDE.set_flag(PageTableFlag::ReadWrite, true);
+    if (mappingFlags & static_cast<uint64_t>(PageTableFlag::UserSuper))
+        PDE.set_flag(PageTableFlag::UserSuper, true);
+    table->entries[index] = PDE;
+    return (PageTable*)((uint64_t)PDE.address() << 12);
+}
+
+void map_pages(PageTable* pageMapLevelFour, void* virtualAddress,
+               void* physicalAddress, uint64_t numPages, uint64_t mappingFlags) {
     if (pageMapLevelFour == nullptr)
         return;
 
-    PageMapIndexer indexer((uint64_t)virtualAddress);
-    PageDirectoryEntry PDE;
+    TRACE_BEGIN(Map, virtualAddress, numPages);
+    LOG(VMM, Trace, "Attempting to map ", numPages, " pages at virtual ", virtualAddress,
+        " to physical ", physicalAddress, " in page table at ", pageMapLevelFour, "\r\n");
 
-    bool present = mappingFlags & static_cast<uint64_t>(PageTableFlag::Present);
-    bool write = mappingFlags & static_cast<uint64_t>(PageTableFlag::ReadWrite);
-    bool user = mappingFlags & static_cast<uint64_t>(PageTableFlag::UserSuper);
-    bool writeThrough =
-        mappingFlags & static_cast<uint64_t>(PageTableFlag::WriteThrough);
-    bool cacheDisabled =
-        mappingFlags & static_cast<uint64_t>(PageTableFlag::CacheDisabled);
-    bool accessed =
-        mappingFlags & static_cast<uint64_t>(PageTableFlag::Accessed);
-    bool dirty = mappingFlags & static_cast<uint64_t>(PageTableFlag::Dirty);
-    bool largerPages =
-        mappingFlags & static_cast<uint64_t>(PageTableFlag::LargerPages);
-    bool global = mappingFlags & static_cast<uint64_t>(PageTableFlag::Global);
-    bool noExecute = mappingFlags & static_cast<uint64_t>(PageTableFlag::NX);
-
-    if (debug == ShowDebug::Yes) {
-        dbgmsg(
-            "Attempting to map virtual %x to physical %x in page table at "
-            "%x\r\n"
-            "  Flags:\r\n"
-            "    Present:         %b\r\n"
-            "    Write:           %b\r\n"
-            "    User-accessible: %b\r\n"
-            "    Write-through:   %b\r\n"
-            "    Cache Disabled:  %b\r\n"
-            "    Accessed:        %b\r\n"
-            "    Dirty:           %b\r\n"
-            "    Larger Pages:    %b\r\n"
-            "    Global:          %b\r\n"
-            "\r\n",
-            virtualAddress, physicalAddress, pageMapLevelFour, present, write,
-            user, writeThrough, cacheDisabled, accessed, dirty, largerPages,
-            global);
-    }
+    PageTable* PT{nullptr};
+    for (uint64_t i = 0; i < numPages; ++i) {
+        uint64_t offset = i * PAGE_SIZE;
+        PageMapIndexer indexer((uint64_t)virtualAddress + offset);
 
-    PDE = pageMapLevelFour->entries[indexer.page_directory_pointer()];
-    PageTable* PDP;
-    if (!PDE.flag(PageTableFlag::Present)) {
-        PDP = (PageTable*)request_page();
-        memset(PDP, 0, PAGE_SIZE);
-        PDE.set_address((uint64_t)PDP >> 12);
-    }
-    PDE.set_flag(PageTableFlag::Present, present);
-    PDE.set_flag(PageTableFlag::ReadWrite, write);
-    PDE.set_flag(PageTableFlag::UserSuper, user);
-    PDE.set_flag(PageTableFlag::WriteThrough, writeThrough);
-    PDE.set_flag(PageTableFlag::CacheDisabled, cacheDisabled);
-    PDE.set_flag(PageTableFlag::Accessed, accessed);
-    PDE.set_flag(PageTableFlag::Dirty, dirty);
-    PDE.set_flag(PageTableFlag::LargerPages, largerPages);
-    PDE.set_flag(PageTableFlag::Global, global);
-    PDE.set_flag(PageTableFlag::Global, noExecute);
-    pageMapLevelFour->entries[indexer.page_directory_pointer()] = PDE;
-    PDP = (PageTable*)((uint64_t)PDE.address() << 12);
+        // The upper levels only need walking when entering a new page table.
+        if (PT == nullptr || indexer.page() == 0) {
+            PageTable* PDP = next_level(
+                pageMapLevelFour, indexer.page_directory_pointer(), mappingFlags);
+            PageTable* PD =
+                next_level(PDP, indexer.page_directory(), mappingFlags);
+            PT = next_level(PD, indexer.page_table(), mappingFlags);
+        }
 
-    PDE = PDP->entries[indexer.page_directory()];
-    PageTable* PD;
-    if (!PDE.flag(PageTableFlag::Present)) {
-        PD = (PageTable*)request_page();
-        memset(PD, 0, PAGE_SIZE);
-        PDE.set_address((uint64_t)PD >> 12);
+        PageDirectoryEntry PDE = PT->entries[indexer.page()];
+        PDE.set_address(((uint64_t)physicalAddress + offset) >> 12);
+        apply_flags(PDE, mappingFlags);
+        PT->entries[indexer.page()] = PDE;
     }
-    PDE.set_flag(PageTableFlag::Present, present);
-    PDE.set_flag(PageTableFlag::ReadWrite, write);
-    PDE.set_flag(PageTableFlag::UserSuper, user);
-    PDE.set_flag(PageTableFlag::WriteThrough, writeThrough);
-    PDE.set_flag(PageTableFlag::CacheDisabled, cacheDisabled);
-    PDE.set_flag(PageTableFlag::Accessed, accessed);
-    PDE.set_flag(PageTableFlag::Dirty, dirty);
-    PDE.set_flag(PageTableFlag::LargerPages, largerPages);
-    PDE.set_flag(PageTableFlag::Global, global);
-    PDE.set_flag(PageTableFlag::Global, noExecute);
-    PDP->entries[indexer.page_directory()] = PDE;
-    PD = (PageTable*)((uint64_t)PDE.address() << 12);
 
-    PDE = PD->entries[indexer.page_table()];
-    PageTable* PT;
-    if (!PDE.flag(PageTableFlag::Present)) {
-        PT = (PageTable*)request_page();
-        memset(PT, 0, PAGE_SIZE);
-        PDE.set_address((uint64_t)PT >> 12);
-    }
-    PDE.set_flag(PageTableFlag::Present, present);
-    PDE.set_flag(PageTableFlag::ReadWrite, write);
-    PDE.set_flag(PageTableFlag::UserSuper, user);
-    PDE.set_flag(PageTableFlag::WriteThrough, writeThrough);
-    PDE.set_flag(PageTableFlag::CacheDisabled, cacheDisabled);
-    PDE.set_flag(PageTableFlag::Accessed, accessed);
-    PDE.set_flag(PageTableFlag::Dirty, dirty);
-    PDE.set_flag(PageTableFlag::LargerPages, largerPages);
-    PDE.set_flag(PageTableFlag::Global, global);
-    PDE.set_flag(PageTableFlag::Global, noExecute);
-    PD->entries[indexer.page_table()] = PDE;
-    PT = (PageTable*)((uint64_t)PDE.address() << 12);
+    LOG(VMM, Trace, "  \033[32mMapped\033[0m\r\n"
+                    "\r\n");
+    TRACE_END(Map, 0, 0);
+}
 
-    PDE = PT->entries[indexer.page()];
-    PDE.set_address((uint64_t)physicalAddress >> 12);
-    PDE.set_flag(PageTableFlag::Present, present);
-    PDE.set_flag(PageTableFlag::ReadWrite, write);
-    PDE.set_flag(PageTableFlag::UserSuper, user);
-    PDE.set_flag(PageTableFlag::WriteThrough, writeThrough);
-    PDE.set_flag(PageTableFlag::CacheDisabled, cacheDisabled);
-    PDE.set_flag(PageTableFlag::Accessed, accessed);
-    PDE.set_flag(PageTableFlag::Dirty, dirty);
-    PDE.set_flag(PageTableFlag::LargerPages, largerPages);
-    PDE.set_flag(PageTableFlag::Global, global);
-    PDE.set_flag(PageTableFlag::Global, noExecute);
-    PT->entries[indexer.page()] = PDE;
-    if (debug == ShowDebug::Yes) {
-        dbgmsg_s(
-            "  \033[32mMapped\033[0m\r\n"
-            "\r\n");
+void map_pages(void* virtualAddress, void* physicalAddress, uint64_t numPages,
+               uint64_t mappingFlags) {
+    map_pages(ActivePageMap, virtualAddress, physicalAddress, numPages,
+              mappingFlags);
+}
+
+void map(PageTable* pageMapLevelFour, void* virtualAddress,
+         void* physicalAddress, uint64_t mappingFlags) {
+    if (pageMapLevelFour == nullptr)
+        return;
+
+    if (LOG_ENABLED(VMM, Trace)) {
+        bool present = mappingFlags & static_cast<uint64_t>(PageTableFlag::Present);
+        bool write = mappingFlags & static_cast<uint64_t>(PageTableFlag::ReadWrite);
+        bool user = mappingFlags & static_cast<uint64_t>(PageTableFlag::UserSuper);
+        bool writeThrough =
+            mappingFlags & static_cast<uint64_t>(PageTableFlag::WriteThrough);
+        bool cacheDisabled =
+            mappingFlags & static_cast<uint64_t>(PageTableFlag::CacheDisabled);
+        bool accessed =
+            mappingFlags & static_cast<uint64_t>(PageTableFlag::Accessed);
+        bool dirty = mappingFlags & static_cast<uint64_t>(PageTableFlag::Dirty);
+        bool largerPages =
+            mappingFlags & static_cast<uint64_t>(PageTableFlag::LargerPages);
+        bool global = mappingFlags & static_cast<uint64_t>(PageTableFlag::Global);
+
+        LOG(VMM, Trace, "Mapping flags for virtual ", virtualAddress, ":\r\n",
+            "    Present:         ", present, "\r\n",
+            "    Write:           ", write, "\r\n",
+            "    User-accessible: ", user, "\r\n",
+            "    Write-through:   ", writeThrough, "\r\n",
+            "    Cache Disabled:  ", cacheDisabled, "\r\n",
+            "    Accessed:        ", accessed, "\r\n",
+            "    Dirty:           ", dirty, "\r\n",
+            "    Larger Pages:    ", largerPages, "\r\n",
+            "    Global:          ", global, "\r\n");
     }
+
+    map_pages(pageMapLevelFour, virtualAddress, physicalAddress, 1,
+              mappingFlags);
 }
 
-void map(void* virtualAddress, void* physicalAddress, uint64_t mappingFlags,
-         ShowDebug debug) {
-    map(ActivePageMap, virtualAddress, physicalAddress, mappingFlags, debug);
+void map(void* virtualAddress, void* physicalAddress, uint64_t mappingFlags) {
+    map(ActivePageMap, virtualAddress, physicalAddress, mappingFlags);
 }
 
-void unmap(PageTable* pageMapLevelFour, void* virtualAddress, ShowDebug debug) {
-    if (debug == ShowDebug::Yes) {
-        dbgmsg("Attempting to unmap virtual %p in page table at %p\r\n",
-               virtualAddress, pageMapLevelFour);
-    }
+void unmap(PageTable* pageMapLevelFour, void* virtualAddress) {
+    LOG(VMM, Trace, "Attempting to unmap virtual ", virtualAddress, " in page table at ",
+        pageMapLevelFour, "\r\n");
     PageMapIndexer indexer((uint64_t)virtualAddress);
     PageDirectoryEntry PDE;
     PDE = pageMapLevelFour->entries[indexer.page_directory_pointer()];
@@ -155,15 +160,48 @@ void unmap(PageTable* pageMapLevelFour, void* virtualAddress, ShowDebug debug) {
     PDE = PT->entries[indexer.page()];
     PDE.set_flag(PageTableFlag::Present, false);
     PT->entries[indexer.page()] = PDE;
-    if (debug == ShowDebug::Yes) {
-        dbgmsg_s(
-            "  \033[32mUnmapped\033[0m\r\n"
-            "\r\n");
-    }
+    // Drop any stale translation the CPU may have cached for this page.
+    if (pageMapLevelFour == ActivePageMap)
+        asm volatile("invlpg (%0)" ::"r"(virtualAddress) : "memory");
+    LOG(VMM, Trace, "  \033[32mUnmapped\033[0m\r\n"
+                    "\r\n");
+}
+
+void unmap(void* virtualAddress) {
+    unmap(ActivePageMap, virtualAddress);
+}
+
+void* virtual_to_physical(PageTable* pageMapLevelFour, void* virtualAddress) {
+    if (pageMapLevelFour == nullptr)
+        return nullptr;
+
+    PageMapIndexer indexer((uint64_t)virtualAddress);
+    PageDirectoryEntry PDE;
+    PDE = pageMapLevelFour->entries[indexer.page_directory_pointer()];
+    if (!PDE.flag(PageTableFlag::Present))
+        return nullptr;
+
+    PageTable* PDP = (PageTable*)((uint64_t)PDE.address() << 12);
+    PDE = PDP->entries[indexer.page_directory()];
+    if (!PDE.flag(PageTableFlag::Present))
+        return nullptr;
+
+    PageTable* PD = (PageTable*)((uint64_t)PDE.address() << 12);
+    PDE = PD->entries[indexer.page_table()];
+    if (!PDE.flag(PageTableFlag::Present))
+        return nullptr;
+
+    PageTable* PT = (PageTable*)((uint64_t)PDE.address() << 12);
+    PDE = PT->entries[indexer.page()];
+    if (!PDE.flag(PageTableFlag::Present))
+        return nullptr;
+
+    return (void*)(((uint64_t)PDE.address() << 12) |
+                   ((uint64_t)virtualAddress & (PAGE_SIZE - 1)));
 }
 
-void unmap(void* virtualAddress, ShowDebug d) {
-    unmap(ActivePageMap, virtualAddress, d);
+void* virtual_to_physical(void* virtualAddress) {
+    return virtual_to_physical(ActivePageMap, virtualAddress);
 }
 
 void flush_page_map(PageTable* pageMapLevelFour) {
@@ -261,21 +299,19 @@ void init_virtual(PageTable* pageMap) {
          * This means that virtual memory addresses will be
          *   equal to physical memory addresses within the kernel.
          */
-    for (uint64_t t = 0; t < total_ram(); t += PAGE_SIZE) {
-        map(pageMap, (void*)t, (void*)t,
-            (uint64_t)PageTableFlag::Present |
-                (uint64_t)PageTableFlag::ReadWrite);
-    }
+    map_pages(pageMap, (void*)0, (void*)0,
+              (total_ram() + PAGE_SIZE - 1) / PAGE_SIZE,
+              (uint64_t)PageTableFlag::Present |
+                  (uint64_t)PageTableFlag::ReadWrite);
     uint64_t kPhysicalStart = (uint64_t)&KERNEL_PHYSICAL;
     uint64_t kernelBytesNeeded =
         1 + ((uint64_t)&KERNEL_END - (uint64_t)&KERNEL_START);
-    for (uint64_t t = kPhysicalStart;
-         t < kPhysicalStart + kernelBytesNeeded + PAGE_SIZE; t += PAGE_SIZE) {
-        map(pageMap, (void*)(t + (uint64_t)&KERNEL_VIRTUAL), (void*)t,
-            (uint64_t)PageTableFlag::Present |
-                (uint64_t)PageTableFlag::ReadWrite |
-                (uint64_t)PageTableFlag::Global);
-    }
+    map_pages(pageMap, (void*)(kPhysicalStart + (uint64_t)&KERNEL_VIRTUAL),
+              (void*)kPhysicalStart,
+              (kernelBytesNeeded + (2 * PAGE_SIZE) - 1) / PAGE_SIZE,
+              (uint64_t)PageTableFlag::Present |
+                  (uint64_t)PageTableFlag::ReadWrite |
+                  (uint64_t)PageTableFlag::Global);
     // Make null-dereference generate exception.
     unmap(nullptr);
     // Update current page map.
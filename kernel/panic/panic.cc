@@ -1,5 +1,6 @@
 #include <cstr.hpp>
 #include <interrupts/interrupts.hpp>
+#include <log/deferred.hpp>
 #include <math.hpp>
 #include <panic/panic.hpp>
 #include <renderer/renderer.hpp>
@@ -9,6 +10,14 @@ Vector2<uint64_t> PanicLocation = {PanicStartX, PanicStartY};
 
 __attribute__((no_caller_saved_registers)) void panic(
     const char* panicMessage) {
+    // The transmit interrupt may never fire again; write straight to the chip.
+    UART::force_synchronous();
+    // Get out what was logged before the panic (and the panic itself, for
+    // the sinks the messages below don't reach), since nothing will flush
+    // it later.
+    LOG_DEFERRED(Kernel, Error, "[PANIC]: {}\r\n", panicMessage);
+    Log::drain_deferred();
+
     UART::out("\r\n\033[1;37;41mEterna PANIC\033[0m\r\n");
     UART::out("   ");
     UART::out(panicMessage);
@@ -27,19 +36,23 @@ __attribute__((no_caller_saved_registers)) void panic(
 __attribute__((no_caller_saved_registers)) void panic(
     InterruptFrame* frame, const char* panicMessage) {
     panic(panicMessage);
+    char ip[TO_HEXSTRING_BUF_SZ];
+    char sp[TO_HEXSTRING_BUF_SZ];
+    to_hexstring(frame->ip, ip);
+    to_hexstring(frame->sp, sp);
 
     UART::out("  Instruction Address: 0x");
-    UART::out(to_hexstring(frame->ip));
+    UART::out(ip);
     UART::out("\r\n");
     UART::out("  Stack Pointer: 0x");
-    UART::out(to_hexstring(frame->sp));
+    UART::out(sp);
     UART::out("\r\n");
 
     gRend.puts(PanicLocation, "Instruction Address: 0x", 0x00000000);
-    gRend.puts(PanicLocation, to_hexstring(frame->ip), 0x00000000);
+    gRend.puts(PanicLocation, ip, 0x00000000);
     gRend.crlf(PanicLocation, PanicStartX);
     gRend.puts(PanicLocation, "Stack Pointer: 0x", 0x00000000);
-    gRend.puts(PanicLocation, to_hexstring(frame->sp), 0x00000000);
+    gRend.puts(PanicLocation, sp, 0x00000000);
     gRend.crlf(PanicLocation, PanicStartX);
 
     // Update entire bottom-right of screen starting at (PanicStartX, PanicStartY).
@@ -49,25 +62,32 @@ __attribute__((no_caller_saved_registers)) void panic(
 __attribute__((no_caller_saved_registers)) void panic(
     InterruptFrameError* frame, const char* panicMessage) {
     panic(panicMessage);
+    char error[TO_HEXSTRING_BUF_SZ];
+    char ip[TO_HEXSTRING_BUF_SZ];
+    char sp[TO_HEXSTRING_BUF_SZ];
+    to_hexstring(frame->error, error);
+    to_hexstring(frame->ip, ip);
+    to_hexstring(frame->sp, sp);
+
     UART::out("  Error Code: 0x");
-    UART::out(to_hexstring(frame->error));
+    UART::out(error);
     UART::out(
         "\r\n"
         "  Instruction Address: 0x");
-    UART::out(to_hexstring(frame->ip));
+    UART::out(ip);
     UART::out("\r\n");
     UART::out("  Stack Pointer: 0x");
-    UART::out(to_hexstring(frame->sp));
+    UART::out(sp);
     UART::out("\r\n");
 
     gRend.puts(PanicLocation, "Error Code: 0x", 0x00000000);
-    gRend.puts(PanicLocation, to_hexstring(frame->error), 0x00000000);
+    gRend.puts(PanicLocation, error, 0x00000000);
     gRend.crlf(PanicLocation, PanicStartX);
     gRend.puts(PanicLocation, "Instruction Address: 0x", 0x00000000);
-    gRend.puts(PanicLocation, to_hexstring(frame->ip), 0x00000000);
+    gRend.puts(PanicLocation, ip, 0x00000000);
     gRend.crlf(PanicLocation, PanicStartX);
     gRend.puts(PanicLocation, "Stack Pointer: 0x", 0x00000000);
-    gRend.puts(PanicLocation, to_hexstring(frame->sp), 0x00000000);
+    gRend.puts(PanicLocation, sp, 0x00000000);
     gRend.crlf(PanicLocation, PanicStartX);
 
     // Update entire bottom-right of screen starting at (PanicStartX, PanicStartY).
@@ -0,0 +1,111 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstr.hpp>
+#include <debug.hpp>
+#include <interrupts/interrupts.hpp>
+#include <io/pit.hpp>
+#include <kernel/commands.hpp>
+#include <log/sinks.hpp>
+#include <profile/profile.hpp>
+#include <string_view.hpp>
+#include <uart.hpp>
+
+// Version of the text written by `Profile::dump()`; see scripts/profile.py.
+#define PROFILE_STREAM_VERSION 1
+
+namespace Profile {
+uint32_t sFrequency{0};
+
+void start() {
+    sFrequency = PIT::set_periodic(PROFILE_FREQUENCY);
+    gProfiling = true;
+    enable_interrupt(IRQ_SYSTEM_TIMER);
+}
+
+void stop() {
+    disable_interrupt(IRQ_SYSTEM_TIMER);
+    gProfiling = false;
+}
+
+static void emit(Trace::Output output, StringView text) {
+    if (output == Trace::Output::Debugcon)
+        Log::write_debugcon(text.data(), text.length());
+    else
+        UART::out_raw((const uint8_t*)text.data(), text.length());
+}
+
+static void emit(Trace::Output output, uint64_t value) {
+    char buffer[TO_STRING_BUF_SZ];
+    emit(output, StringView(buffer, to_string(value, buffer)));
+}
+
+void dump(Trace::Output output) {
+    // Only take what is there now; sampling may carry on meanwhile.
+    uint64_t counts[CPU_MAX_COUNT];
+    uint64_t total = 0;
+    uint64_t dropped = 0;
+    for (uint64_t cpu = 0; cpu < CPU_MAX_COUNT; ++cpu) {
+        counts[cpu] = gProfileBuffers[cpu].Samples.length();
+        total += counts[cpu];
+        dropped += __atomic_exchange_n(&gProfileBuffers[cpu].Dropped, 0, __ATOMIC_RELAXED);
+    }
+
+    emit(output, "ETRNPROF ");
+    emit(output, PROFILE_STREAM_VERSION);
+    emit(output, " hz=");
+    emit(output, sFrequency);
+    emit(output, " samples=");
+    emit(output, total);
+    emit(output, " dropped=");
+    emit(output, dropped);
+    emit(output, "\r\n");
+
+    // Innermost frame first: `<cpu> <ip> <return address>...`
+    char line[4 + PROFILE_STACK_DEPTH * (TO_HEXSTRING_BUF_SZ + 1) + 2];
+    ProfileSample sample;
+    for (uint64_t cpu = 0; cpu < CPU_MAX_COUNT; ++cpu) {
+        for (uint64_t i = 0; i < counts[cpu]; ++i) {
+            if (gProfileBuffers[cpu].Samples.pop(sample) == false)
+                break;
+
+            uint64_t length = to_string(cpu, line);
+            for (uint64_t frame = 0; frame < sample.Depth; ++frame) {
+                line[length++] = ' ';
+                length += to_hexstring(sample.Frames[frame], &line[length]);
+            }
+            line[length++] = '\r';
+            line[length++] = '\n';
+            emit(output, StringView(line, length));
+        }
+    }
+
+    emit(output, "ETRNPROF END\r\n");
+}
+
+static void command(StringView arguments) {
+    uint64_t position = 0;
+    StringView action = Commands::next_word(arguments, position);
+    StringView target = Commands::next_word(arguments, position);
+
+    if (action == "start") {
+        start();
+        dbgmsg("[PROFILE]: Sampling at ", sFrequency, " Hz\r\n");
+    } else if (action == "stop") {
+        stop();
+    } else if (action == "dump") {
+#ifdef QEMU
+        Trace::Output output = target == "serial" ? Trace::Output::Serial
+                                                  : Trace::Output::Debugcon;
+#else
+        Trace::Output output = target == "debugcon" ? Trace::Output::Debugcon
+                                                    : Trace::Output::Serial;
+#endif
+        Profile::dump(output);
+    } else {
+        dbgmsg("Usage: ", gCommand.Usage, "\r\n");
+    }
+}
+
+const Command gCommand{"profile", "profile start | stop | dump [serial|debugcon]", command};
+}  // namespace Profile
@@ -0,0 +1,51 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <link_definitions.hpp>
+#include <profile/profile.hpp>
+
+ProfileBuffer gProfileBuffers[CPU_MAX_COUNT];
+static_assert(constant_initializable<ProfileBuffer>(), "gProfileBuffers needs a constructor");
+bool gProfiling{false};
+
+// Kernel frames (and so the stacks they're on) lie within the kernel image.
+static bool is_kernel_data(uint64_t address) {
+    return address >= (uint64_t)&KERNEL_START && address < (uint64_t)&KERNEL_END;
+}
+
+static bool is_kernel_text(uint64_t address) {
+    return address >= (uint64_t)&TEXT_START && address < (uint64_t)&TEXT_END;
+}
+
+namespace Profile {
+void sample(uint64_t ip, uint64_t framePointer) {
+    if (gProfiling == false)
+        return;
+
+    ProfileSample sample;
+    sample.Frames[0] = ip;
+    sample.Depth = 1;
+
+    /**
+     * Each frame starts with the caller's frame pointer, then the return
+     *  address. Stop at anything that doesn't look like a kernel frame
+     *  further up the stack, as the interrupted code may have been in the
+     *  middle of setting one up (or not use them).
+     */
+    while (sample.Depth < PROFILE_STACK_DEPTH && framePointer % 8 == 0 &&
+           is_kernel_data(framePointer) && is_kernel_data(framePointer + 16)) {
+        uint64_t* frame = (uint64_t*)framePointer;
+        if (is_kernel_text(frame[1]) == false)
+            break;
+
+        sample.Frames[sample.Depth++] = frame[1];
+        if (frame[0] <= framePointer)
+            break;
+        framePointer = frame[0];
+    }
+
+    ProfileBuffer& buffer = gProfileBuffers[CPU::current_index()];
+    if (buffer.Samples.push(sample) == false)
+        __atomic_fetch_add(&buffer.Dropped, 1, __ATOMIC_RELAXED);
+}
+}  // namespace Profile
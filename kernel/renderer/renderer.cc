@@ -7,6 +7,7 @@
 #include <memory/physical_memory_manager.hpp>
 #include <memory/virtual_memory_manager.hpp>
 #include <renderer/renderer.hpp>
+#include <trace/trace.hpp>
 
 // Define global renderer for use anywhere within the kernel.
 Renderer gRend;
@@ -32,8 +33,8 @@ Renderer::Renderer(Framebuffer* render, PSF1_FONT* f)
                     (uint64_t)Memory::PageTableFlag::Present |
                         (uint64_t)Memory::PageTableFlag::ReadWrite);
     }
-    dbgmsg("  Active GOP framebuffer mapped to %x thru %x\r\n", fbBase,
-           fbBase + fbSize);
+    dbgmsg("  Active GOP framebuffer mapped to ", hex(fbBase), " thru ",
+           hex(fbBase + fbSize), "\r\n");
 
     /**
      * @brief Create a new framebuffer. This memory is what will be drawn to.
@@ -54,8 +55,8 @@ Renderer::Renderer(Framebuffer* render, PSF1_FONT* f)
          */
         Target = Render;
     } else {
-        dbgmsg("  Deferred GOP framebuffer allocated at %x thru %x\r\n",
-               target.BaseAddress, (uint64_t)target.BaseAddress + fbSize);
+        dbgmsg("  Deferred GOP framebuffer allocated at ", target.BaseAddress, " thru ",
+               hex((uint64_t)target.BaseAddress + fbSize), "\r\n");
 
         /**
          * @brief If memory allocation succeeds, map meory somewhere
@@ -74,8 +75,8 @@ Renderer::Renderer(Framebuffer* render, PSF1_FONT* f)
         target.BaseAddress = (void*)virtualTargetBaseAddress;
         Target = &target;
 
-        dbgmsg("  Deferred GOP framebuffer mapped to %x thru %x\r\n",
-               virtualTargetBaseAddress, virtualTargetBaseAddress + fbSize);
+        dbgmsg("  Deferred GOP framebuffer mapped to ", hex(virtualTargetBaseAddress), " thru ",
+               hex(virtualTargetBaseAddress + fbSize), "\r\n");
     }
 
     clear();
@@ -89,6 +90,12 @@ inline void Renderer::clamp_draw_position(Vector2<uint64_t>& position) {
         position.y = Target->PixelHeight;
 }
 
+void Renderer::swap() {
+    TRACE_BEGIN(RendererSwap, Target->PixelWidth, Target->PixelHeight);
+    memcpy(Target->BaseAddress, Render->BaseAddress, Target->BufferSize);
+    TRACE_END(RendererSwap, 0, 0);
+}
+
 void Renderer::swap(Vector2<uint64_t> position, Vector2<uint64_t> size) {
     if (Render->BaseAddress == Target->BaseAddress)
         return;
@@ -115,12 +122,14 @@ void Renderer::swap(Vector2<uint64_t> position, Vector2<uint64_t> size) {
         (uint32_t*)((uint64_t)Render->BaseAddress + offset);
     
     // Copy rectangle line-by-line.
+    TRACE_BEGIN(RendererSwap, size.x, size.y);
     uint64_t bytesPerLine = BytesPerPixel * size.x;
     for (uint64_t y = 0; y < size.y; ++y) {
         memcpy(targetBaseAddress, renderBaseAddress, bytesPerLine);
         targetBaseAddress += Target->PixelsPerScanLine;
         renderBaseAddress += Render->PixelsPerScanLine;
     }
+    TRACE_END(RendererSwap, 0, 0);
 }
 
 // carriage return ('\r')
@@ -382,18 +391,11 @@ void Renderer::clearChar(Vector2<uint64_t>& position) {
 }
 
 /**
- * @brief Put a string of characters `str` (null terminated) to the screen
+ * @brief Put a string of characters `str` to the screen
  *      with color `color` at `position`.
  */
-void Renderer::puts(Vector2<uint64_t>& position, const char* str,
+void Renderer::puts(Vector2<uint64_t>& position, StringView str,
                     uint32_t color) {
-    // Set current character to first character in string.
-    char* c = (char*)str;
-
-    // Loop over string until null-terminator.
-    while (*c != 0) {
-        // put current character of string at current pixel position.
-        putChar(position, *c, color);
-        c++;
-    }
+    for (char c : str)
+        putChar(position, c, color);
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <static_key.hpp>
+
+// What the compiler emitted at every site: a 5-byte `nop`.
+static const uint8_t sNop5[5] = {0x0f, 0x1f, 0x44, 0x00, 0x00};
+
+void static_key_set(StaticKey& key, bool enabled) {
+    if (key.Enabled == enabled)
+        return;
+
+    bool interruptsEnabled = CPU::interrupts_enabled();
+    asm volatile("cli" ::: "memory");
+
+    key.Enabled = enabled;
+    for (StaticKeyEntry* entry = STATIC_KEYS_START; entry < STATIC_KEYS_END; ++entry) {
+        if (entry->Key != &key)
+            continue;
+
+        uint8_t* site = (uint8_t*)entry->Site;
+        if (enabled) {
+            // `jmp rel32`, relative to the end of the instruction.
+            uint32_t displacement = (uint32_t)(entry->Target - (entry->Site + 5));
+            site[0] = 0xe9;
+            for (uint8_t i = 0; i < 4; ++i)
+                site[1 + i] = (uint8_t)(displacement >> (i * 8));
+        } else {
+            for (uint8_t i = 0; i < 5; ++i)
+                site[i] = sNop5[i];
+        }
+    }
+
+    // Serialize, so that no stale copy of the old bytes is executed.
+    uint32_t eax, ebx, ecx, edx;
+    CPU::cpuid(0, 0, eax, ebx, ecx, edx);
+
+    if (interruptsEnabled)
+        asm volatile("sti" ::: "memory");
+}
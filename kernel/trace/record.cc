@@ -0,0 +1,27 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <trace/trace.hpp>
+
+StaticKey gTraceKeys[(uint16_t)TraceEvent::Count];
+TraceBuffer gTraceBuffers[CPU_MAX_COUNT];
+static_assert(constant_initializable<TraceBuffer>(), "gTraceBuffers needs a constructor");
+
+namespace Trace {
+void record(TraceEvent event, TracePhase phase, uint64_t arg0, uint64_t arg1) {
+    uint64_t processor = CPU::current_index();
+
+    TraceRecord record;
+    record.Timestamp = CPU::rdtsc();
+    record.Event = (uint16_t)event;
+    record.Phase = (uint8_t)phase;
+    record.Processor = (uint8_t)processor;
+    record.Reserved = 0;
+    record.Args[0] = arg0;
+    record.Args[1] = arg1;
+
+    TraceBuffer& buffer = gTraceBuffers[processor];
+    if (buffer.Records.push(record) == false)
+        __atomic_fetch_add(&buffer.Dropped, 1, __ATOMIC_RELAXED);
+}
+}  // namespace Trace
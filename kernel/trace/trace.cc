@@ -0,0 +1,160 @@
+#include <arch/x86_64/cpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <debug.hpp>
+#include <kernel/commands.hpp>
+#include <log/sinks.hpp>
+#include <static_key.hpp>
+#include <string_view.hpp>
+#include <trace/trace.hpp>
+#include <uart.hpp>
+
+/**
+ * Start of a stream written by `Trace::dump()`. Followed by `EventCount`
+ *  names (a length byte, then that many characters), then `RecordCount`
+ *  `TraceRecord`s, then `TRACE_STREAM_END`.
+ */
+struct TraceStreamHeader {
+    char Magic[8];
+    uint16_t Version;
+    uint16_t RecordSize;
+    uint16_t EventCount;
+    uint16_t Reserved;
+    // TSC frequency, or zero if it hasn't been measured.
+    uint64_t TicksPerSecond;
+    uint64_t RecordCount;
+    // Events lost to full buffers since the last dump.
+    uint64_t Dropped;
+};
+
+#define TRACE_STREAM_MAGIC "ETRNTRC"
+#define TRACE_STREAM_END "ETRNTEND"
+
+namespace Trace {
+const char* event_name(TraceEvent event) {
+    switch (event) {
+    case TraceEvent::Malloc:
+        return "Malloc";
+    case TraceEvent::Free:
+        return "Free";
+    case TraceEvent::RequestPage:
+        return "RequestPage";
+    case TraceEvent::Map:
+        return "Map";
+    case TraceEvent::Interrupt:
+        return "Interrupt";
+    case TraceEvent::RendererSwap:
+        return "RendererSwap";
+    default:
+        return "Unknown";
+    }
+}
+
+void set_enabled(TraceEvent event, bool enabled) {
+    static_key_set(gTraceKeys[(uint16_t)event], enabled);
+}
+
+void set_all_enabled(bool enabled) {
+    for (uint16_t i = 0; i < (uint16_t)TraceEvent::Count; ++i)
+        set_enabled((TraceEvent)i, enabled);
+}
+
+static void emit(Output output, const void* data, uint64_t length) {
+    if (output == Output::Debugcon)
+        Log::write_debugcon(data, length);
+    else
+        UART::out_raw((const uint8_t*)data, length);
+}
+
+void dump(Output output) {
+    // Only take what is there now; tracing may carry on meanwhile.
+    uint64_t counts[CPU_MAX_COUNT];
+    TraceStreamHeader header{};
+    for (uint64_t cpu = 0; cpu < CPU_MAX_COUNT; ++cpu) {
+        counts[cpu] = gTraceBuffers[cpu].Records.length();
+        header.RecordCount += counts[cpu];
+        header.Dropped += __atomic_exchange_n(&gTraceBuffers[cpu].Dropped, 0, __ATOMIC_RELAXED);
+    }
+
+    for (uint8_t i = 0; i < sizeof(header.Magic); ++i)
+        header.Magic[i] = TRACE_STREAM_MAGIC[i];
+    header.Version = TRACE_STREAM_VERSION;
+    header.RecordSize = sizeof(TraceRecord);
+    header.EventCount = (uint16_t)TraceEvent::Count;
+    header.TicksPerSecond = CPU::tsc_frequency();
+    emit(output, &header, sizeof(header));
+
+    for (uint16_t i = 0; i < (uint16_t)TraceEvent::Count; ++i) {
+        StringView name = event_name((TraceEvent)i);
+        uint8_t length = (uint8_t)name.length();
+        emit(output, &length, 1);
+        emit(output, name.data(), length);
+    }
+
+    // A few records at a time, to keep the stack small.
+    TraceRecord records[16];
+    for (uint64_t cpu = 0; cpu < CPU_MAX_COUNT; ++cpu) {
+        uint64_t remaining = counts[cpu];
+        while (remaining) {
+            uint64_t count = remaining < 16 ? remaining : 16;
+            count = gTraceBuffers[cpu].Records.pop(records, count);
+            if (count == 0)
+                break;
+
+            emit(output, records, count * sizeof(TraceRecord));
+            remaining -= count;
+        }
+
+        // Pad with empty records if some vanished, so the count stays true.
+        TraceRecord empty{};
+        empty.Event = 0xffff;
+        for (; remaining; --remaining)
+            emit(output, &empty, sizeof(empty));
+    }
+
+    emit(output, TRACE_STREAM_END, 8);
+}
+
+static bool parse_event(StringView name, TraceEvent& event) {
+    for (uint16_t i = 0; i < (uint16_t)TraceEvent::Count; ++i) {
+        if (name == StringView(event_name((TraceEvent)i))) {
+            event = (TraceEvent)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void command(StringView arguments) {
+    uint64_t position = 0;
+    StringView action = Commands::next_word(arguments, position);
+    StringView target = Commands::next_word(arguments, position);
+
+    if (action == "start" || action == "stop") {
+        bool enabled = action == "start";
+        TraceEvent event;
+        if (target.empty())
+            set_all_enabled(enabled);
+        else if (parse_event(target, event))
+            set_enabled(event, enabled);
+        else
+            dbgmsg("[TRACE]: No event called '", target, "'; try 'trace list'\r\n");
+    } else if (action == "dump") {
+#ifdef QEMU
+        Output output = target == "serial" ? Output::Serial : Output::Debugcon;
+#else
+        Output output = target == "debugcon" ? Output::Debugcon : Output::Serial;
+#endif
+        dump(output);
+    } else if (action == "list") {
+        for (uint16_t i = 0; i < (uint16_t)TraceEvent::Count; ++i)
+            dbgmsg("  ", event_name((TraceEvent)i),
+                   gTraceKeys[i].Enabled ? " (recording)\r\n" : "\r\n");
+    } else {
+        dbgmsg("Usage: ", gCommand.Usage, "\r\n");
+    }
+}
+
+const Command gCommand{
+    "trace", "trace start|stop [event] | dump [serial|debugcon] | list", command};
+}  // namespace Trace
@@ -1,10 +1,33 @@
+#include <arch/x86_64/cpu.hpp>
 #include <cstr.hpp>
 #include <io/io.hpp>
+#include <log/deferred.hpp>
+#include <log/log.hpp>
+#include <ring_buffer.hpp>
+#include <string_view.hpp>
 #include <uart.hpp>
 
 namespace UART {
 bool Initialized{false};
 
+// Filled by the COM1 interrupt handler, drained by the kernel.
+RingBuffer<uint8_t, UART_RECEIVE_BUFFER_SIZE> sReceiveBuffer;
+static_assert(constant_initializable<decltype(sReceiveBuffer)>(), "sReceiveBuffer needs a constructor");
+
+/**
+ * Filled from any context, drained by the transmit interrupt (or, with
+ *  interrupts disabled, by whoever is writing). Everything runs on one
+ *  processor, so the two drains never overlap.
+ */
+RingBuffer<uint8_t, UART_TRANSMIT_BUFFER_SIZE, true> sTransmitBuffer;
+static_assert(constant_initializable<decltype(sTransmitBuffer)>(), "sTransmitBuffer needs a constructor");
+
+// Bytes the chip accepts at once when its transmit FIFO is empty.
+uint8_t sFifoDepth{1};
+
+// Set for good by `force_synchronous()`.
+bool sSynchronous{false};
+
 bool initialized() {
     return Initialized;
 };
@@ -59,8 +82,10 @@ void initialize() {
         if (fifo_test & (1 << 7)) {
             if (fifo_test & (1 << 5)) {
                 chip = Chip::_16750;
+                sFifoDepth = 64;
             } else {
                 chip = Chip::_16550A;
+                sFifoDepth = 16;
             }
         } else {
             chip = Chip::_16550;
@@ -101,17 +126,12 @@ void initialize() {
 
     Initialized = true;
 
-    // First serial messages output from the OS.
+    // First serial messages output from the OS. Interrupts are still off,
+    // so these go straight out.
     out("\r\n\r\nWelcome to \033[5;1;33mEterna\033[0m\r\n\r\n");
     out("[UART]: Initialized driver\r\n  Detected '");
     out(get_uart_chip_name(chip));
     out("' chip\r\n");
-
-#ifdef COM1_INPUT_DEBUG
-    out("[UART]: Data recieved over COM1 will be looped back in the following "
-        "format:\r\n");
-    out("  \"[UART]: COM1 INPUT -> <hexadecimal> <integer> <raw byte>\"");
-#endif
 }
 
 uint8_t read() {
@@ -119,7 +139,7 @@ uint8_t read() {
         return 0;
 
     // Wait until the UART chip flags data is ready to be read from the device.
-    uint16_t maxSpins = (uint16_t)1000000;
+    uint32_t maxSpins = 1000000;
 
     while ((in8(LINE_STATUS_PORT(COM1)) & 0b1) == 0 && maxSpins > 0)
         maxSpins--;
@@ -127,108 +147,221 @@ uint8_t read() {
     if (maxSpins == 0)
         return 0;
 
-    uint8_t data = in8(DATA_PORT(COM1));
-#ifdef COM1_INPUT_DEBUG
-    writestr("[UART]: COM1 INPUT -> 0x");
-    writestr(to_hexstring(data));
-    writeb((uint8_t)' ');
-    writestr(to_string(data));
-    writestr(" \033[30;47m");
-    writeb(data);
-    writestr("\033[0m\r\n");
-#endif
-    return data;
+    return in8(DATA_PORT(COM1));
 }
 
-void out(uint8_t byte) {
-    if (Initialized == false)
+// Move everything in the chip's receive FIFO into the receive buffer.
+static void receive() {
+    // Gather the FIFO's contents first so they're published all at once.
+    uint8_t bytes[64];
+    uint64_t count = 0;
+    while (count < sizeof(bytes) && (in8(LINE_STATUS_PORT(COM1)) & 0b1))
+        bytes[count++] = in8(DATA_PORT(COM1));
+
+    uint64_t pushed = sReceiveBuffer.push(bytes, count);
+    if (pushed < count)
+        LOG_DEFERRED(UART, Warning, "[UART]: Receive buffer full, dropped {} bytes\r\n",
+                     count - pushed);
+}
+
+// Have the chip interrupt us once its transmit FIFO is empty.
+static void start_transmit() {
+    out8(INTERRUPT_PORT(COM1),
+         INTERRUPT_PORT_DATA_AVAILABLE | INTERRUPT_PORT_TRANSMITTER_HOLDING_REGISTER_EMPTY);
+}
+
+// Refill the (empty) transmit FIFO, or stop the interrupt once there's nothing left.
+static void transmit() {
+    uint8_t bytes[64];
+    uint64_t count = sTransmitBuffer.pop(bytes, sFifoDepth);
+    if (count == 0) {
+        out8(INTERRUPT_PORT(COM1), INTERRUPT_PORT_DATA_AVAILABLE);
         return;
+    }
+
+    for (uint64_t i = 0; i < count; ++i)
+        out8(DATA_PORT(COM1), bytes[i]);
+}
 
-    /**
-     * @brief Wait for UART chip to empty it's transmit buffer before
-     *   potentially over-writing data that was not yet sent.
-    */
-    uint16_t maxSpins = (uint16_t)1000000;
+// Wait for the transmit FIFO to empty. @return false if it never does.
+static bool wait_for_transmitter() {
+    uint32_t maxSpins = 1000000;
 
     while ((in8(LINE_STATUS_PORT(COM1)) & (1 << 5)) == 0 && maxSpins > 0)
         maxSpins--;
 
-    if (maxSpins == 0)
+    return maxSpins > 0;
+}
+
+// Write `numBytes` bytes to the chip directly, a FIFO's worth at a time.
+static void transmit_synchronously(const uint8_t* bytes, uint64_t numBytes) {
+    while (numBytes) {
+        if (wait_for_transmitter() == false)
+            return;
+
+        uint64_t count = numBytes < sFifoDepth ? numBytes : sFifoDepth;
+        for (uint64_t i = 0; i < count; ++i)
+            out8(DATA_PORT(COM1), bytes[i]);
+
+        bytes += count;
+        numBytes -= count;
+    }
+}
+
+// Write out everything queued. Interrupts must be disabled.
+static void drain() {
+    uint8_t bytes[64];
+    uint64_t count;
+    while ((count = sTransmitBuffer.pop(bytes, sFifoDepth)))
+        transmit_synchronously(bytes, count);
+}
+
+static void write(const uint8_t* bytes, uint64_t numBytes) {
+    if (numBytes == 0)
+        return;
+
+    if (sSynchronous || CPU::interrupts_enabled() == false) {
+        // Whatever was queued before has to go out first.
+        drain();
+        transmit_synchronously(bytes, numBytes);
         return;
+    }
 
-    out8(COM1, byte);
+    while (true) {
+        uint64_t pushed = sTransmitBuffer.push(bytes, numBytes);
+        bytes += pushed;
+        numBytes -= pushed;
+        if (numBytes == 0)
+            break;
+
+        // The queue is full; rather than drop output, send it ourselves.
+        asm volatile("cli" ::: "memory");
+        drain();
+        asm volatile("sti" ::: "memory");
+    }
+
+    start_transmit();
 }
 
-void out(const char* str) {
+void handle_interrupt() {
     if (Initialized == false)
         return;
 
-    // Set current character to beginning of string.
-    char* c = (char*)str;
-    // Check for null-terminator at current character.
-    while (*c != '\0') {
-#ifdef UART_HIDE_COLOR_CODES
-        if (*c == '\033') {
-            // Loop until null terminator or 'm'.
-            do {
-                c++;
-            } while (*c != 'm' && *c != '\0');
+    // Bit 0 of the interrupt ID is clear while an interrupt is pending.
+    uint8_t id;
+    while (((id = in8(INT_ID_PORT(COM1))) & 0b1) == 0) {
+        switch ((id >> 1) & 0b111) {
+            case 0b001:
+                transmit();
+                break;
+
+            case 0b010:
+            case 0b110:
+                // Data available, or some left in the FIFO for a while.
+                receive();
+                break;
+
+            case 0b011: {
+                // Reading the line status acknowledges the error.
+                uint8_t status = in8(LINE_STATUS_PORT(COM1));
+                LOG_DEFERRED(UART, Warning, "[UART]: Line status error {}\r\n", hex(status));
+                break;
+            }
 
-            // Don't read memory past null terminator!
-            if (*c == '\0')
-                return;
+            default:
+                in8(MODEM_STATUS_PORT(COM1));
+                break;
+        }
+    }
+}
 
-            // Skip the 'm'.
-            c++;
+void force_synchronous() {
+    sSynchronous = true;
 
-            if (*c == '\0')
-                return;
-        }
-#endif  // UART_HIDE_COLOR_CODES
+    if (Initialized == false)
+        return;
 
-        out((uint8_t)*c);
-        c++;
+    bool enabled = CPU::interrupts_enabled();
+    asm volatile("cli" ::: "memory");
+    drain();
+    if (enabled)
+        asm volatile("sti" ::: "memory");
+}
+
+uint64_t read_buffered(uint8_t* buffer, uint64_t maxBytes) {
+    uint64_t count = sReceiveBuffer.pop(buffer, maxBytes);
+    if (LOG_ENABLED(UART, Debug)) {
+        for (uint64_t i = 0; i < count; ++i) {
+            LOG(UART, Debug, "[UART]: COM1 INPUT -> ", hex(buffer[i]), ' ', buffer[i],
+                " \033[30;47m", (char)buffer[i], "\033[0m\r\n");
+        }
     }
+    return count;
 }
 
-void out(uint8_t* str, uint64_t numberOfBytes) {
+void out(uint8_t byte) {
     if (Initialized == false)
         return;
 
-    while (numberOfBytes > 0) {
-#ifdef UART_HIDE_COLOR_CODES
-        if (*str == '\033') {
-            // Loop until no more chars or 'm'
-            do {
-                str++;
-                numberOfBytes--;
-            } while (*str != 'm' && numberOfBytes > 0);
-
-            if (*str == 'm') {
-                str++;
-                numberOfBytes--;
-            } else {
-                return;
-            }
-        }
-#endif // UART_HIDE_COLOR_CODES
-        out((uint8_t)*str);
+    write(&byte, 1);
+}
+
+void out(const char* str) {
+    out(StringView(str));
+}
+
+void out(uint8_t* buffer, uint64_t numberOfBytes) {
+    out(StringView((const char*)buffer, numberOfBytes));
+}
+
+void out_raw(const uint8_t* buffer, uint64_t numberOfBytes) {
+    if (Initialized == false)
+        return;
+
+    write(buffer, numberOfBytes);
+}
+
+void out(StringView text) {
+    if (Initialized == false)
+        return;
 
-        str++;
-        numberOfBytes--;
+#ifdef UART_HIDE_COLOR_CODES
+    // Write the runs of text between color codes.
+    uint64_t start = 0;
+    while (start < text.length()) {
+        uint64_t escape = text.find('\033', start);
+        if (escape == StringView::npos)
+            escape = text.length();
+
+        write((const uint8_t*)text.data() + start, escape - start);
+        if (escape == text.length())
+            return;
+
+        // Skip up to and including the 'm', or to the end of the text.
+        uint64_t end = text.find('m', escape);
+        if (end == StringView::npos)
+            return;
+
+        start = end + 1;
     }
+#else
+    write((const uint8_t*)text.data(), text.length());
+#endif  // UART_HIDE_COLOR_CODES
 }
 
 void out(uint64_t number) {
-    out(to_string(number));
+    char buffer[TO_STRING_BUF_SZ];
+    out(StringView(buffer, to_string(number, buffer)));
 }
 
 void out(uint32_t number) {
-    out(to_string(number));
+    char buffer[TO_STRING_BUF_SZ];
+    out(StringView(buffer, to_string(number, buffer)));
 }
 
 void out(uint16_t number) {
-    out(to_string(number));
+    char buffer[TO_STRING_BUF_SZ];
+    out(StringView(buffer, to_string(number, buffer)));
 }
 
 }  // namespace UART
\ No newline at end of file
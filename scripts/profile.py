@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# Symbolize what `profile dump` wrote (over COM1 or to debugcon.log)
+# against kernel.elf, then print a flat profile, or folded stacks for
+# flamegraph.pl / speedscope.
+#
+# Usage: profile.py debugcon.log [--elf bin/kernel.elf] [--folded] [--top 30]
+
+import argparse
+import bisect
+import collections
+import subprocess
+import sys
+
+BEGIN = "ETRNPROF "
+END = "ETRNPROF END"
+VERSION = 1
+
+
+class Symbols:
+    def __init__(self, elf, nm):
+        output = subprocess.run([nm, "-n", "-C", "--defined-only", elf],
+                                check=True, capture_output=True, text=True).stdout
+        self.addresses = []
+        self.names = []
+        for line in output.splitlines():
+            parts = line.split(" ", 2)
+            if len(parts) != 3 or parts[1] not in "tTwW":
+                continue
+            self.addresses.append(int(parts[0], 16))
+            self.names.append(parts[2])
+
+    def lookup(self, address):
+        index = bisect.bisect_right(self.addresses, address) - 1
+        if index < 0:
+            return f"0x{address:x}"
+        return self.names[index]
+
+
+def read_samples(path):
+    """@return every sample (innermost frame first) of every dump in `path`."""
+    samples = []
+    dropped = 0
+    in_dump = False
+    with open(path, "rb") as f:
+        for raw in f:
+            line = raw.decode("ascii", "replace").strip()
+            if line.startswith(END):
+                in_dump = False
+            elif line.startswith(BEGIN):
+                fields = dict(field.split("=", 1) for field in line.split()[2:] if "=" in field)
+                version = int(line.split()[1])
+                if version != VERSION:
+                    sys.exit(f"profile dump version {version}, expected {VERSION}")
+                dropped += int(fields.get("dropped", 0))
+                in_dump = True
+            elif in_dump and line:
+                samples.append([int(frame, 16) for frame in line.split()[1:]])
+    return samples, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolize kernel profile dumps.")
+    parser.add_argument("input", help="file holding one or more dumps")
+    parser.add_argument("--elf", default="bin/kernel.elf", help="kernel image with symbols")
+    parser.add_argument("--nm", default="nm", help="nm to use (e.g. x86_64-elf-nm)")
+    parser.add_argument("--folded", action="store_true",
+                        help="print folded stacks instead of a flat profile")
+    parser.add_argument("--top", type=int, default=30, help="functions in the flat profile")
+    args = parser.parse_args()
+
+    samples, dropped = read_samples(args.input)
+    if not samples:
+        sys.exit(f"{args.input}: no profile samples found")
+    if dropped:
+        print(f"warning: {dropped} samples were dropped by full buffers", file=sys.stderr)
+
+    symbols = Symbols(args.elf, args.nm)
+    # Look up return addresses one byte back, within the call that made them.
+    stacks = [[symbols.lookup(frame - (i > 0)) for i, frame in enumerate(sample)]
+              for sample in samples]
+
+    if args.folded:
+        folded = collections.Counter(";".join(reversed(stack)) for stack in stacks)
+        for stack, count in folded.most_common():
+            print(f"{stack} {count}")
+        return
+
+    self_counts = collections.Counter(stack[0] for stack in stacks)
+    # Count recursive functions once per sample.
+    total_counts = collections.Counter(name for stack in stacks for name in set(stack))
+
+    print(f"{len(samples)} samples")
+    print(f"{'self':>7} {'self%':>6} {'total':>7} {'total%':>6}  function")
+    for name, count in self_counts.most_common(args.top):
+        total = total_counts[name]
+        print(f"{count:7} {100 * count / len(samples):6.2f} "
+              f"{total:7} {100 * total / len(samples):6.2f}  {name}")
+
+
+if __name__ == "__main__":
+    main()
@@ -24,6 +24,7 @@ qemu-system-x86_64 \
     -soundhw pcspk \
     -net none \
     -rtc base=localtime,clock=host,driftfix=none \
+    -debugcon file:debugcon.log \
     -drive format=raw,file=$BuildDirectory/Eterna.img \
     -drive if=pflash,format=raw,unit=0,file=$OVMFDirectory/OVMF_CODE-pure-efi.fd,readonly=on \
     -drive if=pflash,format=raw,unit=1,file=$OVMFDirectory/OVMF_VARS_Eterna.fd
\ No newline at end of file
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# Convert what `trace dump` wrote (over COM1 or to debugcon.log) into the
+# Chrome trace event format, for chrome://tracing or ui.perfetto.dev.
+#
+# Usage: trace2chrome.py debugcon.log [-o trace.json] [--tsc-mhz 3000]
+#
+# Anything around the dumps (ordinary log output) is skipped, and every
+# dump found in the file is converted.
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"ETRNTRC\0"
+END = b"ETRNTEND"
+VERSION = 1
+
+# See `TraceStreamHeader` in kernel/trace/trace.cc.
+HEADER = struct.Struct("<8sHHHHQQQ")
+# See `TraceRecord` in include/trace/trace.hpp.
+RECORD = struct.Struct("<QHBBIQQ")
+
+PHASES = {0: "i", 1: "B", 2: "E"}
+EMPTY_EVENT = 0xFFFF
+
+
+def parse_dump(data, offset):
+    """Parse one dump starting at `offset`; return (records, names, ticks, dropped, end)."""
+    (_, version, record_size, event_count, _, ticks_per_second, record_count,
+     dropped) = HEADER.unpack_from(data, offset)
+    if version != VERSION:
+        raise ValueError(f"stream version {version}, expected {VERSION}")
+    if record_size != RECORD.size:
+        raise ValueError(f"record size {record_size}, expected {RECORD.size}")
+    offset += HEADER.size
+
+    names = []
+    for _ in range(event_count):
+        length = data[offset]
+        names.append(data[offset + 1:offset + 1 + length].decode("ascii"))
+        offset += 1 + length
+
+    records = []
+    for _ in range(record_count):
+        records.append(RECORD.unpack_from(data, offset))
+        offset += RECORD.size
+
+    if data[offset:offset + len(END)] != END:
+        raise ValueError("dump is truncated or corrupt (no end marker)")
+    return records, names, ticks_per_second, dropped, offset + len(END)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert kernel trace dumps to Chrome trace JSON.")
+    parser.add_argument("input", help="file holding one or more dumps")
+    parser.add_argument("-o", "--output", help="where to write JSON (default: stdout)")
+    parser.add_argument("--tsc-mhz", type=float,
+                        help="TSC frequency, if the dump doesn't record one")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    events = []
+    offset = data.find(MAGIC)
+    if offset < 0:
+        sys.exit(f"{args.input}: no trace dump found")
+
+    while offset >= 0:
+        records, names, ticks, dropped, offset = parse_dump(data, offset)
+        if args.tsc_mhz:
+            ticks = args.tsc_mhz * 1e6
+        if not ticks:
+            print("warning: TSC frequency unknown; timestamps are in cycles "
+                  "(pass --tsc-mhz)", file=sys.stderr)
+            ticks = 1e6
+        if dropped:
+            print(f"warning: {dropped} events were dropped by full buffers",
+                  file=sys.stderr)
+
+        for timestamp, event, phase, cpu, _, arg0, arg1 in records:
+            if event == EMPTY_EVENT:
+                continue
+            name = names[event] if event < len(names) else f"Event{event}"
+            events.append({
+                "name": name,
+                "ph": PHASES.get(phase, "i"),
+                "ts": timestamp * 1e6 / ticks,
+                "pid": 0,
+                "tid": cpu,
+                "args": {"arg0": hex(arg0), "arg1": hex(arg1)},
+            })
+        offset = data.find(MAGIC, offset)
+
+    # Each processor's records are in order, but the processors aren't interleaved.
+    events.sort(key=lambda e: e["ts"])
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, out)
+    out.write("\n")
+
+
+if __name__ == "__main__":
+    main()